@@ -8,8 +8,8 @@
 // Sets default values
 AFireBlob::AFireBlob()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// The heatmap drives size changes, so the effect does not need to tick.
+	PrimaryActorTick.bCanEverTick = false;
 	
 	//Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root Component"));
 	//RootComponent = Root;
@@ -31,16 +31,14 @@ void AFireBlob::BeginPlay()
 	
 }
 
-// Called every frame
-void AFireBlob::Tick(float DeltaTime)
+void AFireBlob::PauseFireEffect()
 {
-	Super::Tick(DeltaTime);
-
+	NiagaraComponent->SetPaused(true);
 }
 
-void AFireBlob::PauseFireEffect()
+void AFireBlob::ResumeFireEffect()
 {
-	NiagaraComponent->SetPaused(true);
+	NiagaraComponent->SetPaused(false);
 }
 
 float AFireBlob::GetTimeToBurnOut() const
@@ -67,3 +65,26 @@ uint8 AFireBlob::GetMarkForDestroy()
 {
 	return MarkForDestroy;
 }
+
+void AFireBlob::ReturnToPool()
+{
+	NiagaraComponent->Deactivate();
+	SetActorHiddenInGame(true);
+	SetActorTickEnabled(false);
+
+	IsPending = 0;
+	MarkForDestroy = 0;
+}
+
+void AFireBlob::ReuseFromPool(const FTransform& SpawnTransform)
+{
+	SetActorTransform(SpawnTransform);
+	SetFireSize(1.f);
+	BurnOutDelay = FMath::RandRange(2.f, 4.f);
+
+	SetActorHiddenInGame(false);
+	SetActorTickEnabled(PrimaryActorTick.bStartWithTickEnabled);
+
+	NiagaraComponent->SetPaused(false);
+	NiagaraComponent->Activate(true);
+}
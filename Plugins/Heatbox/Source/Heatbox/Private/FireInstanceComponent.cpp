@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireInstanceComponent.h"
+#include "NiagaraDataInterfaceArrayFunctionLibrary.h"
+
+UFireInstanceComponent::UFireInstanceComponent()
+{
+	PositionsParameter = "FirePositions";
+	SizesParameter = "FireSizes";
+	IntensitiesParameter = "FireIntensities";
+
+	bAutoActivate = false;
+}
+
+void UFireInstanceComponent::BeginFires()
+{
+	Positions.Reset();
+	Sizes.Reset();
+	Intensities.Reset();
+}
+
+void UFireInstanceComponent::AddFire(const FVector& Position, const FVector& Size, float Intensity)
+{
+	Positions.Add(Position);
+	Sizes.Add(Size);
+	Intensities.Add(Intensity);
+}
+
+void UFireInstanceComponent::FlushFires()
+{
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(this, PositionsParameter, Positions);
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayVector(this, SizesParameter, Sizes);
+	UNiagaraDataInterfaceArrayFunctionLibrary::SetNiagaraArrayFloat(this, IntensitiesParameter, Intensities);
+
+	if (Positions.Num() > 0 && !IsActive()) {
+		Activate();
+	}
+}
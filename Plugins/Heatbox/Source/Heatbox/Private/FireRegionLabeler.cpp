@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireRegionLabeler.h"
+
+int FireRegionLabeler::Label(const TArray<FIntVector>& Cells)
+{
+	const int NumCells = Cells.Num();
+
+	Parent.SetNumUninitialized(NumCells);
+	RegionOf.SetNumUninitialized(NumCells);
+	RegionStarts.Reset();
+	RegionElements.SetNumUninitialized(NumCells);
+	RegionSignatures.Reset();
+
+	if (NumCells == 0) {
+		RegionStarts.Add(0);
+		return 0;
+	}
+
+	// 경계 상자
+	FIntVector Min = Cells[0];
+	FIntVector Max = Cells[0];
+	for (const FIntVector& Cell : Cells) {
+		Min = FIntVector(FMath::Min(Min.X, Cell.X), FMath::Min(Min.Y, Cell.Y), FMath::Min(Min.Z, Cell.Z));
+		Max = FIntVector(FMath::Max(Max.X, Cell.X), FMath::Max(Max.Y, Cell.Y), FMath::Max(Max.Z, Cell.Z));
+	}
+
+	const int SizeX = Max.X - Min.X + 1;
+	const int SizeY = Max.Y - Min.Y + 1;
+	const int SizeZ = Max.Z - Min.Z + 1;
+
+	auto GridIndex = [&](int X, int Y, int Z) {
+		return (X - Min.X) + SizeX * ((Y - Min.Y) + SizeY * (Z - Min.Z));
+	};
+
+	Occupancy.Reset();
+	Occupancy.SetNumZeroed(SizeX * SizeY * SizeZ);
+
+	for (int i = 0; i < NumCells; i++) {
+		Parent[i] = i;
+		Occupancy[GridIndex(Cells[i].X, Cells[i].Y, Cells[i].Z)] = i + 1;
+	}
+
+	// -X, -Y 이웃만 확인해도 모든 4-이웃 쌍이 한 번씩 합쳐집니다.
+	for (int i = 0; i < NumCells; i++) {
+		const FIntVector& Cell = Cells[i];
+
+		if (Cell.X > Min.X) {
+			const int Neighbor = Occupancy[GridIndex(Cell.X - 1, Cell.Y, Cell.Z)];
+			if (Neighbor > 0) {
+				Union(i, Neighbor - 1);
+			}
+		}
+
+		if (Cell.Y > Min.Y) {
+			const int Neighbor = Occupancy[GridIndex(Cell.X, Cell.Y - 1, Cell.Z)];
+			if (Neighbor > 0) {
+				Union(i, Neighbor - 1);
+			}
+		}
+	}
+
+	// 루트는 항상 집합에서 가장 작은 인덱스이므로 첫 등장 순서로 영역 번호를 매길 수 있습니다.
+	int NumRegions = 0;
+	for (int i = 0; i < NumCells; i++) {
+		const int Root = FindRoot(i);
+		RegionOf[i] = (Root == i) ? NumRegions++ : RegionOf[Root];
+	}
+
+	// 영역별 구간 (계수 정렬)과 시그니처
+	RegionStarts.SetNumZeroed(NumRegions + 1);
+	RegionSignatures.SetNumZeroed(NumRegions);
+	for (int i = 0; i < NumCells; i++) {
+		RegionStarts[RegionOf[i] + 1]++;
+		RegionSignatures[RegionOf[i]] += HashCell(Cells[i]);
+	}
+
+	for (int Region = 0; Region < NumRegions; Region++) {
+		RegionStarts[Region + 1] += RegionStarts[Region];
+	}
+
+	// Parent는 더 이상 필요하지 않으므로 채울 위치로 재사용합니다.
+	for (int Region = 0; Region < NumRegions; Region++) {
+		Parent[Region] = RegionStarts[Region];
+	}
+
+	for (int i = 0; i < NumCells; i++) {
+		RegionElements[Parent[RegionOf[i]]++] = i;
+	}
+
+	return NumRegions;
+}
+
+int FireRegionLabeler::GetNumRegions() const
+{
+	return RegionStarts.Num() - 1;
+}
+
+TConstArrayView<int> FireRegionLabeler::GetRegion(int Region) const
+{
+	return TConstArrayView<int>(RegionElements.GetData() + RegionStarts[Region], RegionStarts[Region + 1] - RegionStarts[Region]);
+}
+
+int FireRegionLabeler::GetRegionOf(int CellIndex) const
+{
+	return RegionOf[CellIndex];
+}
+
+uint64 FireRegionLabeler::GetRegionSignature(int Region) const
+{
+	return RegionSignatures[Region];
+}
+
+uint64 FireRegionLabeler::Mix(uint64 Value)
+{
+	Value += 0x9E3779B97F4A7C15ull;
+	Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+	return Value ^ (Value >> 31);
+}
+
+uint64 FireRegionLabeler::HashCell(const FIntVector& Cell)
+{
+	// 축마다 21비트
+	const uint64 Packed = ((uint64)(Cell.X & 0x1FFFFF)) | ((uint64)(Cell.Y & 0x1FFFFF) << 21) | ((uint64)(Cell.Z & 0x1FFFFF) << 42);
+	return Mix(Packed);
+}
+
+int FireRegionLabeler::FindRoot(int Element)
+{
+	// 경로 절반 압축
+	while (Parent[Element] != Element) {
+		Parent[Element] = Parent[Parent[Element]];
+		Element = Parent[Element];
+	}
+
+	return Element;
+}
+
+void FireRegionLabeler::Union(int A, int B)
+{
+	A = FindRoot(A);
+	B = FindRoot(B);
+
+	if (A == B) {
+		return;
+	}
+
+	if (A < B) {
+		Parent[B] = A;
+	}
+	else {
+		Parent[A] = B;
+	}
+}
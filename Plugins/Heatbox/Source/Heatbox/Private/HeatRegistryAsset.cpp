@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HeatRegistryAsset.h"
+
+void UHeatRegistryAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	CellMapIndex.BulkSerialize(Ar);
+	CellOccupancy.BulkSerialize(Ar);
+	CellSampleStart.BulkSerialize(Ar);
+	CellSampleCount.BulkSerialize(Ar);
+	SurfaceSamples.BulkSerialize(Ar);
+}
+
+void UHeatRegistryAsset::Reset()
+{
+	BoxOwners.Reset();
+	FlammableActors.Reset();
+	CellMapIndex.Reset();
+	CellOccupancy.Reset();
+	CellSampleStart.Reset();
+	CellSampleCount.Reset();
+	SurfaceSamples.Reset();
+}
+
+bool UHeatRegistryAsset::MatchesHeatmap(const FTransform& InHeatmapTransform, const FIntVector& InNumCells) const
+{
+	const int NumBakedCells = CellMapIndex.Num();
+	if (CellOccupancy.Num() != NumBakedCells || CellSampleStart.Num() != NumBakedCells || CellSampleCount.Num() != NumBakedCells) {
+		return false;
+	}
+
+	return NumCells == InNumCells && HeatmapTransform.Equals(InHeatmapTransform);
+}
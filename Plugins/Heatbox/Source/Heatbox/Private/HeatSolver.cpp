@@ -0,0 +1,468 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HeatSolver.h"
+#include "Async/ParallelFor.h"
+
+HeatSolver::HeatSolver(int NumDepthCells, int NumWidthCells, int NumHeightCells, float HeatTransferRate)
+	: NumDepthCells(NumDepthCells),
+	NumWidthCells(NumWidthCells),
+	NumHeightCells(NumHeightCells),
+	HeatTransferRate(HeatTransferRate),
+	PlaneSize((NumDepthCells + 2) * (NumWidthCells + 2)),
+	NumBricksX(FMath::DivideAndRoundUp(NumDepthCells, BrickSize)),
+	NumBricksY(FMath::DivideAndRoundUp(NumWidthCells, BrickSize)),
+	NumBricksZ(FMath::DivideAndRoundUp(NumHeightCells, BrickSize))
+{
+	BrickActive.Init(0, NumBricksX * NumBricksY * NumBricksZ);
+}
+
+float HeatSolver::RelaxSerial(const TArray<float>& Source, TArray<float>& Field) const
+{
+	float Residual = 0.f;
+
+	for (int i = 1; i <= NumDepthCells; i++) {
+		for (int j = 1; j <= NumWidthCells; j++) {
+			for (int k = 1; k <= NumHeightCells; k++) {
+				const float Relaxed = (
+					Source[CoreIndex(i, j, k)] +
+					HeatTransferRate * (
+						Field[CoreIndex(i - 1, j, k)] + Field[CoreIndex(i + 1, j, k)] +
+						Field[CoreIndex(i, j - 1, k)] + Field[CoreIndex(i, j + 1, k)] +
+						Field[CoreIndex(i, j, k - 1)] + Field[CoreIndex(i, j, k + 1)])
+					) / (1 + 6 * HeatTransferRate);
+
+				Residual = FMath::Max(Residual, FMath::Abs(Relaxed - Field[CoreIndex(i, j, k)]));
+				Field[CoreIndex(i, j, k)] = Relaxed;
+			}
+		}
+	}
+
+	return Residual;
+}
+
+float HeatSolver::RelaxParallel(const TArray<float>& Source, TArray<float>& Field, int NumSlabs)
+{
+	NumSlabs = GetNumSlabs(NumSlabs);
+
+	if (NumSlabs <= 1) {
+		return RelaxSerial(Source, Field);
+	}
+
+	// Halo 교환: 각 슬랩의 바로 아래/위 평면을 스윕 시작 시점 값으로 복사해 둡니다.
+	HaloPlanes.SetNumUninitialized(2 * NumSlabs * PlaneSize);
+
+	for (int s = 0; s < NumSlabs; s++) {
+		const int KBegin = 1 + (s * NumHeightCells) / NumSlabs;
+		const int KEnd = ((s + 1) * NumHeightCells) / NumSlabs;
+
+		FMemory::Memcpy(&HaloPlanes[(2 * s) * PlaneSize], &Field[CoreIndex(0, 0, KBegin - 1)], PlaneSize * sizeof(float));
+		FMemory::Memcpy(&HaloPlanes[(2 * s + 1) * PlaneSize], &Field[CoreIndex(0, 0, KEnd + 1)], PlaneSize * sizeof(float));
+	}
+
+	SlabResiduals.Init(0.f, NumSlabs);
+
+	ParallelFor(NumSlabs, [&](int32 s) {
+		const int KBegin = 1 + (s * NumHeightCells) / NumSlabs;
+		const int KEnd = ((s + 1) * NumHeightCells) / NumSlabs;
+
+		const float* HaloBelow = &HaloPlanes[(2 * s) * PlaneSize];
+		const float* HaloAbove = &HaloPlanes[(2 * s + 1) * PlaneSize];
+
+		for (int k = KBegin; k <= KEnd; k++) {
+			const float* Below = (k == KBegin) ? HaloBelow : &Field[CoreIndex(0, 0, k - 1)];
+			const float* Above = (k == KEnd) ? HaloAbove : &Field[CoreIndex(0, 0, k + 1)];
+
+			const float PlaneResidual = RelaxPlane(&Source[CoreIndex(0, 0, k)], &Field[CoreIndex(0, 0, k)], Below, Above);
+			SlabResiduals[s] = FMath::Max(SlabResiduals[s], PlaneResidual);
+		}
+	});
+
+	float Residual = 0.f;
+	for (float SlabResidual : SlabResiduals) {
+		Residual = FMath::Max(Residual, SlabResidual);
+	}
+
+	return Residual;
+}
+
+void HeatSolver::MarkCellActive(int X, int Y, int Z)
+{
+	if (X < 0 || X >= NumDepthCells || Y < 0 || Y >= NumWidthCells || Z < 0 || Z >= NumHeightCells) {
+		return;
+	}
+
+	BrickActive[BrickIndex(X / BrickSize, Y / BrickSize, Z / BrickSize)] = 1;
+}
+
+void HeatSolver::ResetBricks()
+{
+	BrickActive.Init(0, NumBricksX * NumBricksY * NumBricksZ);
+	SweepBricks.Reset();
+}
+
+int HeatSolver::BeginSparseSolve()
+{
+	SweepBricks.Reset();
+
+	for (int BZ = 0; BZ < NumBricksZ; BZ++) {
+		for (int BY = 0; BY < NumBricksY; BY++) {
+			for (int BX = 0; BX < NumBricksX; BX++) {
+				bool bNearActive = false;
+
+				for (int NZ = FMath::Max(BZ - 1, 0); NZ <= FMath::Min(BZ + 1, NumBricksZ - 1) && !bNearActive; NZ++) {
+					for (int NY = FMath::Max(BY - 1, 0); NY <= FMath::Min(BY + 1, NumBricksY - 1) && !bNearActive; NY++) {
+						for (int NX = FMath::Max(BX - 1, 0); NX <= FMath::Min(BX + 1, NumBricksX - 1) && !bNearActive; NX++) {
+							bNearActive = BrickActive[BrickIndex(NX, NY, NZ)] != 0;
+						}
+					}
+				}
+
+				if (bNearActive) {
+					SweepBricks.Add(BrickIndex(BX, BY, BZ));
+				}
+			}
+		}
+	}
+
+	return SweepBricks.Num();
+}
+
+float HeatSolver::RelaxSparse(const TArray<float>& Source, TArray<float>& Field, bool bParallel)
+{
+	float Residual = 0.f;
+
+	if (!bParallel) {
+		for (int Brick : SweepBricks) {
+			Residual = FMath::Max(Residual, RelaxBrick(Brick, Source, Field));
+		}
+
+		return Residual;
+	}
+
+	// 같은 색상(각 축 브릭 좌표의 홀짝)의 브릭끼리는 최소 한 브릭 이상 떨어져 있어 동시에 갱신해도 안전합니다.
+	BrickResiduals.Init(0.f, SweepBricks.Num());
+
+	TArray<int> ColorBricks;
+	for (int Color = 0; Color < 8; Color++) {
+		ColorBricks.Reset();
+
+		for (int n = 0; n < SweepBricks.Num(); n++) {
+			const int Brick = SweepBricks[n];
+			const int BX = Brick % NumBricksX;
+			const int BY = (Brick / NumBricksX) % NumBricksY;
+			const int BZ = Brick / (NumBricksX * NumBricksY);
+
+			if (((BX & 1) | ((BY & 1) << 1) | ((BZ & 1) << 2)) == Color) {
+				ColorBricks.Add(n);
+			}
+		}
+
+		ParallelFor(ColorBricks.Num(), [&](int32 n) {
+			const int SweepIdx = ColorBricks[n];
+			BrickResiduals[SweepIdx] = FMath::Max(BrickResiduals[SweepIdx], RelaxBrick(SweepBricks[SweepIdx], Source, Field));
+		});
+	}
+
+	for (float BrickResidual : BrickResiduals) {
+		Residual = FMath::Max(Residual, BrickResidual);
+	}
+
+	return Residual;
+}
+
+void HeatSolver::EndSparseSolve(TArray<float>& Field, float Threshold)
+{
+	for (int Brick : SweepBricks) {
+		const int BX = Brick % NumBricksX;
+		const int BY = (Brick / NumBricksX) % NumBricksY;
+		const int BZ = Brick / (NumBricksX * NumBricksY);
+
+		const int IEnd = FMath::Min((BX + 1) * BrickSize, NumDepthCells);
+		const int JEnd = FMath::Min((BY + 1) * BrickSize, NumWidthCells);
+		const int KEnd = FMath::Min((BZ + 1) * BrickSize, NumHeightCells);
+
+		float MaxHeat = 0.f;
+		for (int k = BZ * BrickSize + 1; k <= KEnd; k++) {
+			for (int i = BX * BrickSize + 1; i <= IEnd; i++) {
+				for (int j = BY * BrickSize + 1; j <= JEnd; j++) {
+					MaxHeat = FMath::Max(MaxHeat, FMath::Abs(Field[CoreIndex(i, j, k)]));
+				}
+			}
+		}
+
+		BrickActive[Brick] = (MaxHeat > Threshold) ? 1 : 0;
+
+		// 무시할 만한 잔열은 비워서 비활성 브릭이 계속 열을 방출하지 않도록 합니다.
+		if (!BrickActive[Brick]) {
+			for (int k = BZ * BrickSize + 1; k <= KEnd; k++) {
+				for (int i = BX * BrickSize + 1; i <= IEnd; i++) {
+					for (int j = BY * BrickSize + 1; j <= JEnd; j++) {
+						Field[CoreIndex(i, j, k)] = 0.f;
+					}
+				}
+			}
+		}
+	}
+}
+
+int HeatSolver::GetNumActiveBricks() const
+{
+	int NumActive = 0;
+	for (uint8 Active : BrickActive) {
+		NumActive += Active;
+	}
+
+	return NumActive;
+}
+
+float HeatSolver::ComputeResidual(const TArray<float>& Source, const TArray<float>& Field, TArray<float>& OutResidual) const
+{
+	OutResidual.Init(0.f, GetFieldSize());
+
+	const float Diagonal = 1 + 6 * HeatTransferRate;
+	float MaxResidual = 0.f;
+
+	for (int k = 1; k <= NumHeightCells; k++) {
+		for (int i = 1; i <= NumDepthCells; i++) {
+			for (int j = 1; j <= NumWidthCells; j++) {
+				const int Idx = CoreIndex(i, j, k);
+				const float Neighbors =
+					Field[CoreIndex(i - 1, j, k)] + Field[CoreIndex(i + 1, j, k)] +
+					Field[CoreIndex(i, j - 1, k)] + Field[CoreIndex(i, j + 1, k)] +
+					Field[CoreIndex(i, j, k - 1)] + Field[CoreIndex(i, j, k + 1)];
+
+				OutResidual[Idx] = Source[Idx] - (Diagonal * Field[Idx] - HeatTransferRate * Neighbors);
+				MaxResidual = FMath::Max(MaxResidual, FMath::Abs(OutResidual[Idx]));
+			}
+		}
+	}
+
+	return MaxResidual / Diagonal;
+}
+
+int HeatSolver::GetNumSlabs(int RequestedSlabs) const
+{
+	if (RequestedSlabs <= 0) {
+		RequestedSlabs = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	}
+
+	// 슬랩 하나가 최소 두 평면은 갖도록 하여 halo 경계의 비율을 제한합니다.
+	return FMath::Clamp(RequestedSlabs, 1, FMath::Max(1, NumHeightCells / 2));
+}
+
+int HeatSolver::GetFieldSize() const
+{
+	return PlaneSize * (NumHeightCells + 2);
+}
+
+int HeatSolver::BrickIndex(int BX, int BY, int BZ) const
+{
+	return BX + NumBricksX * (BY + NumBricksY * BZ);
+}
+
+float HeatSolver::RelaxBrick(int Brick, const TArray<float>& Source, TArray<float>& Field) const
+{
+	const int BX = Brick % NumBricksX;
+	const int BY = (Brick / NumBricksX) % NumBricksY;
+	const int BZ = Brick / (NumBricksX * NumBricksY);
+
+	const int IEnd = FMath::Min((BX + 1) * BrickSize, NumDepthCells);
+	const int JEnd = FMath::Min((BY + 1) * BrickSize, NumWidthCells);
+	const int KEnd = FMath::Min((BZ + 1) * BrickSize, NumHeightCells);
+
+	const int RowSize = NumWidthCells + 2;
+	const float Denominator = 1 + 6 * HeatTransferRate;
+	float Residual = 0.f;
+
+	for (int k = BZ * BrickSize + 1; k <= KEnd; k++) {
+		for (int i = BX * BrickSize + 1; i <= IEnd; i++) {
+			for (int j = BY * BrickSize + 1; j <= JEnd; j++) {
+				const int Idx = CoreIndex(i, j, k);
+				const float Relaxed = (
+					Source[Idx] +
+					HeatTransferRate * (
+						Field[Idx - RowSize] + Field[Idx + RowSize] +
+						Field[Idx - 1] + Field[Idx + 1] +
+						Field[Idx - PlaneSize] + Field[Idx + PlaneSize])
+					) / Denominator;
+
+				Residual = FMath::Max(Residual, FMath::Abs(Relaxed - Field[Idx]));
+				Field[Idx] = Relaxed;
+			}
+		}
+	}
+
+	return Residual;
+}
+
+int HeatSolver::CoreIndex(int i, int j, int k) const
+{
+	return j + ((NumWidthCells + 2) * i) + (PlaneSize * k);
+}
+
+float HeatSolver::RelaxPlane(const float* Source, float* Field, const float* Below, const float* Above) const
+{
+	const int RowSize = NumWidthCells + 2;
+	const float Denominator = 1 + 6 * HeatTransferRate;
+	float Residual = 0.f;
+
+	for (int i = 1; i <= NumDepthCells; i++) {
+		for (int j = 1; j <= NumWidthCells; j++) {
+			const int PlaneIdx = j + RowSize * i;
+			const float Relaxed = (
+				Source[PlaneIdx] +
+				HeatTransferRate * (
+					Field[PlaneIdx - RowSize] + Field[PlaneIdx + RowSize] +
+					Field[PlaneIdx - 1] + Field[PlaneIdx + 1] +
+					Below[PlaneIdx] + Above[PlaneIdx])
+				) / Denominator;
+
+			Residual = FMath::Max(Residual, FMath::Abs(Relaxed - Field[PlaneIdx]));
+			Field[PlaneIdx] = Relaxed;
+		}
+	}
+
+	return Residual;
+}
+
+HeatMultigrid::HeatMultigrid(int NumDepthCells, int NumWidthCells, int NumHeightCells, float HeatTransferRate, int MaxLevels)
+{
+	int D = NumDepthCells;
+	int W = NumWidthCells;
+	int H = NumHeightCells;
+	float Rate = HeatTransferRate;
+
+	while (true) {
+		FGridLevel& Level = Levels.AddDefaulted_GetRef();
+		Level.Solver = HeatSolver(D, W, H, Rate);
+		Level.Residual.Init(0.f, Level.Solver.GetFieldSize());
+
+		// 최상위 레벨은 호출자의 필드를 그대로 사용합니다.
+		if (Levels.Num() > 1) {
+			Level.Field.Init(0.f, Level.Solver.GetFieldSize());
+			Level.Source.Init(0.f, Level.Solver.GetFieldSize());
+		}
+
+		if (Levels.Num() >= MaxLevels || D <= 2 || W <= 2 || H <= 2) {
+			break;
+		}
+
+		D = (D + 1) / 2;
+		W = (W + 1) / 2;
+		H = (H + 1) / 2;
+		Rate /= 4.f;
+	}
+}
+
+float HeatMultigrid::VCycle(const TArray<float>& Source, TArray<float>& Field, bool bParallel, int NumSlabs)
+{
+	check(IsValid());
+
+	const int Coarsest = Levels.Num() - 1;
+
+	// 하강: 전평활 후 잔차를 거친 격자로 제한
+	for (int l = 0; l < Coarsest; l++) {
+		const TArray<float>& LevelSource = (l == 0) ? Source : Levels[l].Source;
+		TArray<float>& LevelField = (l == 0) ? Field : Levels[l].Field;
+
+		for (int n = 0; n < NumPreSmooth; n++) {
+			Relax(l, LevelSource, LevelField, bParallel, NumSlabs);
+		}
+
+		Levels[l].Solver.ComputeResidual(LevelSource, LevelField, Levels[l].Residual);
+		Restrict(l, Levels[l].Residual);
+	}
+
+	// 최하위 레벨은 충분히 스윕하여 근사 해를 구합니다.
+	float Residual = 0.f;
+	{
+		const TArray<float>& LevelSource = (Coarsest == 0) ? Source : Levels[Coarsest].Source;
+		TArray<float>& LevelField = (Coarsest == 0) ? Field : Levels[Coarsest].Field;
+		const HeatSolver& CoarseSolver = Levels[Coarsest].Solver;
+
+		const int NumCoarseSweeps = (Coarsest == 0) ? NumPreSmooth + NumPostSmooth :
+			2 * FMath::Max3(CoarseSolver.GetNumDepthCells(), CoarseSolver.GetNumWidthCells(), CoarseSolver.GetNumHeightCells());
+
+		for (int n = 0; n < NumCoarseSweeps; n++) {
+			Residual = Relax(Coarsest, LevelSource, LevelField, bParallel, NumSlabs);
+		}
+	}
+
+	// 상승: 보정값 보간 후 후평활
+	for (int l = Coarsest - 1; l >= 0; l--) {
+		const TArray<float>& LevelSource = (l == 0) ? Source : Levels[l].Source;
+		TArray<float>& LevelField = (l == 0) ? Field : Levels[l].Field;
+
+		Prolongate(l, LevelField);
+
+		for (int n = 0; n < NumPostSmooth; n++) {
+			Residual = Relax(l, LevelSource, LevelField, bParallel, NumSlabs);
+		}
+	}
+
+	return Residual;
+}
+
+int HeatMultigrid::GetNumLevels() const
+{
+	return Levels.Num();
+}
+
+bool HeatMultigrid::IsValid() const
+{
+	return Levels.Num() > 0;
+}
+
+float HeatMultigrid::Relax(int Level, const TArray<float>& Source, TArray<float>& Field, bool bParallel, int NumSlabs)
+{
+	if (bParallel) {
+		return Levels[Level].Solver.RelaxParallel(Source, Field, NumSlabs);
+	}
+	else {
+		return Levels[Level].Solver.RelaxSerial(Source, Field);
+	}
+}
+
+void HeatMultigrid::Restrict(int FineLevel, const TArray<float>& FineResidual)
+{
+	const HeatSolver& Fine = Levels[FineLevel].Solver;
+	FGridLevel& Coarse = Levels[FineLevel + 1];
+
+	Coarse.Field.Init(0.f, Coarse.Solver.GetFieldSize());
+	Coarse.Source.Init(0.f, Coarse.Solver.GetFieldSize());
+
+	for (int k = 1; k <= Coarse.Solver.GetNumHeightCells(); k++) {
+		for (int i = 1; i <= Coarse.Solver.GetNumDepthCells(); i++) {
+			for (int j = 1; j <= Coarse.Solver.GetNumWidthCells(); j++) {
+				float Sum = 0.f;
+				int NumChildren = 0;
+
+				for (int fk = 2 * k - 1; fk <= FMath::Min(2 * k, Fine.GetNumHeightCells()); fk++) {
+					for (int fi = 2 * i - 1; fi <= FMath::Min(2 * i, Fine.GetNumDepthCells()); fi++) {
+						for (int fj = 2 * j - 1; fj <= FMath::Min(2 * j, Fine.GetNumWidthCells()); fj++) {
+							Sum += FineResidual[Fine.CoreIndex(fi, fj, fk)];
+							NumChildren++;
+						}
+					}
+				}
+
+				Coarse.Source[Coarse.Solver.CoreIndex(i, j, k)] = Sum / NumChildren;
+			}
+		}
+	}
+}
+
+void HeatMultigrid::Prolongate(int FineLevel, TArray<float>& FineField) const
+{
+	const HeatSolver& Fine = Levels[FineLevel].Solver;
+	const FGridLevel& Coarse = Levels[FineLevel + 1];
+
+	for (int k = 1; k <= Fine.GetNumHeightCells(); k++) {
+		for (int i = 1; i <= Fine.GetNumDepthCells(); i++) {
+			for (int j = 1; j <= Fine.GetNumWidthCells(); j++) {
+				FineField[Fine.CoreIndex(i, j, k)] += Coarse.Field[Coarse.Solver.CoreIndex((i + 1) / 2, (j + 1) / 2, (k + 1) / 2)];
+			}
+		}
+	}
+}
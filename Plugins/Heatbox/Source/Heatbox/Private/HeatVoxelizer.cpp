@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HeatVoxelizer.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Math/RandomStream.h"
+
+HeatVoxelizer::HeatVoxelizer(const FTransform& HeatmapTransform, int NumDepthCells, int NumWidthCells, int NumHeightCells, int SamplesPerCell)
+	: HeatmapTransform(HeatmapTransform),
+	NumDepthCells(NumDepthCells),
+	NumWidthCells(NumWidthCells),
+	NumHeightCells(NumHeightCells),
+	SamplesPerCell(SamplesPerCell)
+{}
+
+bool HeatVoxelizer::AddStaticMesh(const UStaticMeshComponent* MeshComp)
+{
+	const UStaticMesh* StaticMesh = MeshComp ? MeshComp->GetStaticMesh() : nullptr;
+	if (!StaticMesh || SamplesPerCell <= 0) {
+		return false;
+	}
+
+#if !WITH_EDITOR
+	// 쿡된 빌드에서는 CPU 접근이 허용된 메쉬만 읽을 수 있습니다.
+	if (!StaticMesh->bAllowCPUAccess) {
+		return false;
+	}
+#endif
+
+	const FStaticMeshRenderData* RenderData = StaticMesh->GetRenderData();
+	if (!RenderData || RenderData->LODResources.Num() == 0) {
+		return false;
+	}
+
+	const FStaticMeshLODResources& LOD = RenderData->LODResources[0];
+	const FPositionVertexBuffer& Positions = LOD.VertexBuffers.PositionVertexBuffer;
+	const FIndexArrayView Indices = LOD.IndexBuffer.GetArrayView();
+	if (Indices.Num() < 3 || Positions.GetNumVertices() == 0) {
+		return false;
+	}
+
+	// 메쉬 로컬 -> 히트맵 로컬 (비균등 스케일 포함)
+	const FMatrix MeshToHeatmap = MeshComp->GetComponentTransform().ToMatrixWithScale() * HeatmapTransform.ToMatrixWithScale().Inverse();
+
+	// 같은 메쉬는 항상 같은 샘플을 만듭니다.
+	FRandomStream RandomStream(Indices.Num());
+
+	const double CellFaceArea = 100. * 100.;
+
+	for (int Index = 0; Index + 2 < Indices.Num(); Index += 3) {
+		const FVector A = MeshToHeatmap.TransformPosition(FVector(Positions.VertexPosition(Indices[Index])));
+		const FVector B = MeshToHeatmap.TransformPosition(FVector(Positions.VertexPosition(Indices[Index + 1])));
+		const FVector C = MeshToHeatmap.TransformPosition(FVector(Positions.VertexPosition(Indices[Index + 2])));
+
+		const double Area = 0.5 * FVector::CrossProduct(B - A, C - A).Size();
+		if (Area <= UE_KINDA_SMALL_NUMBER) {
+			continue;
+		}
+
+		const int NumSamples = FMath::Clamp(FMath::CeilToInt(Area / CellFaceArea * SamplesPerCell * Oversampling), 1, 1 << 16);
+
+		for (int n = 0; n < NumSamples; n++) {
+			// 삼각형 위 균등 분포
+			const float R1 = FMath::Sqrt(RandomStream.GetFraction());
+			const float R2 = RandomStream.GetFraction();
+			const FVector Sample = (1.f - R1) * A + R1 * (1.f - R2) * B + R1 * R2 * C;
+
+			FIntVector MapIndex;
+			if (GetCellIndex(Sample, MapIndex)) {
+				CandidatesAt.FindOrAdd(MapIndex).Add(Sample);
+			}
+		}
+	}
+
+	return true;
+}
+
+void HeatVoxelizer::GetSurfaceSamples(TMap<FIntVector, TArray<FVector>>& OutSamplesAt) const
+{
+	OutSamplesAt.Reset();
+	OutSamplesAt.Reserve(CandidatesAt.Num());
+
+	for (const auto& CandidateAt : CandidatesAt) {
+		const TArray<FVector>& Candidates = CandidateAt.Value;
+		const int NumSamples = FMath::Min(Candidates.Num(), SamplesPerCell);
+
+		TArray<FVector>& Samples = OutSamplesAt.Add(CandidateAt.Key);
+		Samples.Reserve(NumSamples);
+
+		// 후보 전체에서 고른 간격으로 고릅니다.
+		for (int n = 0; n < NumSamples; n++) {
+			const int Candidate = (int)((int64)n * Candidates.Num() / NumSamples);
+			Samples.Add(HeatmapTransform.TransformPosition(Candidates[Candidate]));
+		}
+	}
+}
+
+void HeatVoxelizer::Reset()
+{
+	CandidatesAt.Reset();
+}
+
+void HeatVoxelizer::RasterizeCollision(const UPrimitiveComponent* PrimComp, TSet<FIntVector>& InOutRasterized, TArray<FIntVector>& OutMapIndices, TArray<float>* OutOccupancy) const
+{
+	const FQuat HeatmapRotation = HeatmapTransform.GetRotation();
+	const FVector CellExtent = 50.f * HeatmapTransform.GetScale3D();
+	const FCollisionShape CellShape = FCollisionShape::MakeBox(CellExtent);
+	const FCollisionShape SubCellShape = FCollisionShape::MakeBox(CellExtent / OccupancySubdivisions);
+
+	// 월드 경계 상자 -> 히트맵 로컬 셀 범위
+	const FBox LocalBounds = PrimComp->Bounds.GetBox().InverseTransformBy(HeatmapTransform);
+	const FIntVector MinIndex(
+		FMath::Max(FMath::FloorToInt((LocalBounds.Min.X + 50.) / 100.), 0),
+		FMath::Max(FMath::FloorToInt((LocalBounds.Min.Y + 50.) / 100.), 0),
+		FMath::Max(FMath::FloorToInt((LocalBounds.Min.Z + 50.) / 100.), 0));
+	const FIntVector MaxIndex(
+		FMath::Min(FMath::FloorToInt((LocalBounds.Max.X + 50.) / 100.), NumDepthCells - 1),
+		FMath::Min(FMath::FloorToInt((LocalBounds.Max.Y + 50.) / 100.), NumWidthCells - 1),
+		FMath::Min(FMath::FloorToInt((LocalBounds.Max.Z + 50.) / 100.), NumHeightCells - 1));
+
+	for (int i = MinIndex.X; i <= MaxIndex.X; i++) {
+		for (int j = MinIndex.Y; j <= MaxIndex.Y; j++) {
+			for (int k = MinIndex.Z; k <= MaxIndex.Z; k++) {
+				const FIntVector MapIndex(i, j, k);
+				if (InOutRasterized.Contains(MapIndex)) {
+					continue;
+				}
+
+				// 경계 상자만 겹치고 충돌체는 닿지 않는 셀 제외
+				const FVector CellLocalPos(100. * i, 100. * j, 100. * k);
+				if (!PrimComp->OverlapComponent(HeatmapTransform.TransformPosition(CellLocalPos), HeatmapRotation, CellShape)) {
+					continue;
+				}
+
+				InOutRasterized.Add(MapIndex);
+				OutMapIndices.Add(MapIndex);
+
+				if (OutOccupancy) {
+					int NumOccupied = 0;
+					for (int a = 0; a < OccupancySubdivisions; a++) {
+						for (int b = 0; b < OccupancySubdivisions; b++) {
+							for (int c = 0; c < OccupancySubdivisions; c++) {
+								const FVector SubCellOffset = 100. * (FVector(a, b, c) + 0.5) / OccupancySubdivisions - FVector(50.);
+								NumOccupied += PrimComp->OverlapComponent(HeatmapTransform.TransformPosition(CellLocalPos + SubCellOffset), HeatmapRotation, SubCellShape) ? 1 : 0;
+							}
+						}
+					}
+
+					OutOccupancy->Add((float)NumOccupied / (OccupancySubdivisions * OccupancySubdivisions * OccupancySubdivisions));
+				}
+			}
+		}
+	}
+}
+
+bool HeatVoxelizer::GetCellIndex(const FVector& LocalPos, FIntVector& OutMapIndex) const
+{
+	OutMapIndex = FIntVector((int)FMath::RoundHalfFromZero(LocalPos.X / 100),
+							(int)FMath::RoundHalfFromZero(LocalPos.Y / 100),
+							(int)FMath::RoundHalfFromZero(LocalPos.Z / 100));
+
+	return OutMapIndex.X >= 0 && OutMapIndex.X < NumDepthCells
+		&& OutMapIndex.Y >= 0 && OutMapIndex.Y < NumWidthCells
+		&& OutMapIndex.Z >= 0 && OutMapIndex.Z < NumHeightCells;
+}
@@ -7,8 +7,16 @@
 #include "Components/BoxComponent.h"
 #include "DrawDebugHelpers.h"
 #include "PointEstimator.h"
+#include "HeatVoxelizer.h"
+#include "HeatRegistryAsset.h"
+#include "HitQuerySampler.h"
 #include "FireBlob.h"
+#include "FireInstanceComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Kismet/GameplayStatics.h"
+#include "GameFramework/PlayerController.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
 
 
 #include <string>
@@ -22,14 +30,14 @@ using namespace std;
 		UE_LOG(TemperatureLog, Warning, TEXT("")); \
 		UE_LOG(TemperatureLog, Warning, TEXT("%17s%22s%30s%17s"), *FString("Box Owner"), *FString("Map Index"), *FString("Current Temperature"), *FString("Ignition Point")); \
 	}
-#define TEMPERATURE_LOG_BODY(index) \
+#define TEMPERATURE_LOG_BODY(slot) \
 	if (bShowTemperatureLog) { \
-		UE_LOG(TemperatureLog, Log, TEXT("%25s%25s%14.2f%23.2f"), *FString(BoxOwner->GetActorLabel()), *index.ToString(), HeatBoxInfo.CurrTemperature, HeatBoxInfo.IgnitionPoint); \
+		UE_LOG(TemperatureLog, Log, TEXT("%25s%25s%14.2f%23.2f"), *FString(CellStore.GetBoxOwner(slot)->GetActorLabel()), *CellStore.MapIndex[slot].ToString(), CellStore.CurrTemperature[slot], CellStore.GetMaterial(slot).IgnitionPoint); \
 	}
 
 #else
 #define TEMPERATURE_LOG_HEADER()
-#define TEMPERATURE_LOG_BODY(index)
+#define TEMPERATURE_LOG_BODY(slot)
 #endif
 
 #if WITH_EDITOR
@@ -38,14 +46,14 @@ using namespace std;
 		UE_LOG(MiscLog, Warning, TEXT("")); \
 		UE_LOG(MiscLog, Warning, TEXT("%18s%21s%26s%21s%14s"), *FString("Box Owner"), *FString("Map Index"), *FString("HeatAbsorbRate"), *FString("HeatEmitRate"), *FString("FuelCount")); \
 	}
-#define MISC_LOG_BODY(index) \
+#define MISC_LOG_BODY(slot) \
 	if (bShowMiscLog) { \
-		UE_LOG(MiscLog, Log, TEXT("%25s%25s%14.2f%23.2f%17.2f"), *FString(BoxOwner->GetActorLabel()), *index.ToString(), HeatBoxInfo.HeatAbsorbRate, HeatBoxInfo.HeatEmitRate, HeatBoxInfo.FuelCount); \
+		UE_LOG(MiscLog, Log, TEXT("%25s%25s%14.2f%23.2f%17.2f"), *FString(CellStore.GetBoxOwner(slot)->GetActorLabel()), *CellStore.MapIndex[slot].ToString(), CellStore.GetMaterial(slot).HeatAbsorbRate, CellStore.GetMaterial(slot).HeatEmitRate, CellStore.FuelCount[slot]); \
 	}
 
 #else
 #define MISC_LOG_HEADER()
-#define MISC_LOG_BODY(index)
+#define MISC_LOG_BODY(slot)
 #endif
 
 #if WITH_EDITOR
@@ -54,14 +62,14 @@ using namespace std;
 		UE_LOG(HeatDamageLog, Warning, TEXT("")); \
 		UE_LOG(HeatDamageLog, Warning, TEXT("%16s%23s%31s%24s"), *FString("Box Owner"), *FString("Map Index"), *FString("Heat Damage Applied"), *FString("Heat Damage Received")); \
 	}
-#define HEATDMG_LOG_BODY(index) \
+#define HEATDMG_LOG_BODY(slot) \
 	if (bHeatDamageLog) { \
-		UE_LOG(HeatDamageLog, Log, TEXT("%25s%25s%14.2f%23.2f"), *FString(BoxOwner->GetActorLabel()), *index.ToString(), HeatBoxInfo.HeatDamageApplied, HeatBoxInfo.HeatDamageReceived); \
+		UE_LOG(HeatDamageLog, Log, TEXT("%25s%25s%14.2f%23.2f"), *FString(CellStore.GetBoxOwner(slot)->GetActorLabel()), *CellStore.MapIndex[slot].ToString(), CellStore.HeatDamageApplied[slot], CellStore.HeatDamageReceived[slot]); \
 	}
 
 #else
 #define TEMPERATURE_LOG_HEADER()
-#define TEMPERATURE_LOG_BODY(index)
+#define TEMPERATURE_LOG_BODY(slot)
 #endif
 
 float Sigma = 5.6703e-8; // The Stefan-Boltzmann Constant [W/m2K4]
@@ -72,60 +80,372 @@ FName BurntOut = "BurntOut";
 
 FFireInBox::~FFireInBox() 
 {
-	if(FireEffect) {
+	if (AHeatmap* Heatmap = EffectPool.Get()) {
+		Heatmap->ReleaseFireEffect(FireEffect);
+	}
+
+	else if (FireEffect) {
 		FireEffect->Destroy();
 	}
  
 }
 
+void FFireInBox::SetEffectLOD(FireEffectLOD NewLOD)
+{
+	if (!FireEffect || EffectLOD == NewLOD) {
+		return;
+	}
+
+	switch (NewLOD)
+	{
+	case FireEffectLOD::Full:
+		FireEffect->SetActorHiddenInGame(false);
+		FireEffect->ResumeFireEffect();
+		break;
+
+	case FireEffectLOD::Paused:
+		FireEffect->SetActorHiddenInGame(false);
+		FireEffect->PauseFireEffect();
+		break;
+
+	case FireEffectLOD::Hidden:
+		FireEffect->PauseFireEffect();
+		FireEffect->SetActorHiddenInGame(true);
+		break;
+
+	default:
+		break;
+	}
+
+	EffectLOD = NewLOD;
+}
+
 void FFireInBox::SetFireSize(float Size)
 {
-	FireEffect->SetFireSize(Size);
+	FireSize = Size;
+
+	if (FireEffect) {
+		FireEffect->SetFireSize(Size);
+	}
+}
+
+int FHeatCellStore::AddOwner(AActor* InBoxOwner, const FHeatBoxMaterial& Material)
+{
+	check(!HandleOf.Contains(InBoxOwner));
+
+	const int Handle = Owners.Add(InBoxOwner);
+	Materials.Add(Material);
+	FaceHitWeights.AddUninitialized(HitQuerySampler::NumFaces);
+	for (int Face = 0; Face < HitQuerySampler::NumFaces; Face++) {
+		FaceHitWeights[Handle * HitQuerySampler::NumFaces + Face] = 1.f;
+	}
+	SlotsOf.AddDefaulted();
+	HandleOf.Add(InBoxOwner, Handle);
+
+	return Handle;
+}
+
+int FHeatCellStore::FindOwner(const AActor* InBoxOwner) const
+{
+	const int* Found = HandleOf.Find(InBoxOwner);
+	return Found ? *Found : INDEX_NONE;
+}
+
+int FHeatCellStore::GetNumOwners() const
+{
+	return Owners.Num();
+}
+
+int FHeatCellStore::AddCell(const FIntVector& InMapIndex, int InCoreIdx, int InOwnerHandle, const FHeatBoxInfoDefaultInit& HeatBoxInfoInit)
+{
+	int Slot;
+
+	if (FreeSlots.Num() > 0) {
+		Slot = FreeSlots.Pop();
+	}
+
+	else {
+		Slot = Phase.Num();
+
+		CurrTemperature.AddUninitialized();
+		FuelCount.AddUninitialized();
+		IsBurning.AddUninitialized();
+		OwnerHandle.AddUninitialized();
+		MapIndex.AddUninitialized();
+		CoreIdx.AddUninitialized();
+		Phase.AddUninitialized();
+		RadiationArea.AddUninitialized();
+		HeatDamageApplied.AddUninitialized();
+		HeatDamageReceived.AddUninitialized();
+		IgnitionCore.AddUninitialized();
+		HitQueryCount.AddUninitialized();
+		HitQueryAttempts.AddUninitialized();
+		HitQueryInFlight.AddUninitialized();
+		HitPoints.AddDefaulted();
+		Occupancy.AddUninitialized();
+
+		// Reset 뒤에도 세대는 남아 있으므로 처음 쓰는 슬롯만 추가합니다.
+		if (Slot == SlotGeneration.Num()) {
+			SlotGeneration.Add(0);
+		}
+		SurfaceSampleStart.AddUninitialized();
+		SurfaceSampleCount.AddUninitialized();
+		SlotListIndex.AddUninitialized();
+	}
+
+	CurrTemperature[Slot] = HeatBoxInfoInit.CurrTemperature;
+	FuelCount[Slot] = Materials[InOwnerHandle].FuelCount;
+	IsBurning[Slot] = HeatBoxInfoInit.IsBurning;
+	OwnerHandle[Slot] = InOwnerHandle;
+	MapIndex[Slot] = InMapIndex;
+	CoreIdx[Slot] = InCoreIdx;
+	Phase[Slot] = HeatCellPhase::Flammable;
+	RadiationArea[Slot] = HeatBoxInfoInit.RadiationArea;
+	HeatDamageApplied[Slot] = 0.f;
+	HeatDamageReceived[Slot] = 0.f;
+	IgnitionCore[Slot] = FVector::ZeroVector;
+	HitQueryCount[Slot] = HITQUERY_REQ;
+	HitQueryAttempts[Slot] = 0;
+	HitQueryInFlight[Slot] = 0;
+	HitPoints[Slot].Reset();
+	Occupancy[Slot] = 1.f;
+	SurfaceSampleStart[Slot] = 0;
+	SurfaceSampleCount[Slot] = 0;
+
+	SlotListIndex[Slot] = SlotsOf[InOwnerHandle].Add(Slot);
+
+	return Slot;
+}
+
+void FHeatCellStore::RemoveCell(int Slot)
+{
+	check(IsValidSlot(Slot));
+
+	// 마지막 슬롯을 빈자리로 옮겨 목록에서 상수 시간에 뺍니다.
+	TArray<int>& OwnerSlots = SlotsOf[OwnerHandle[Slot]];
+	const int ListIndex = SlotListIndex[Slot];
+	const int LastSlot = OwnerSlots.Last();
+	OwnerSlots[ListIndex] = LastSlot;
+	SlotListIndex[LastSlot] = ListIndex;
+	OwnerSlots.Pop(false);
+
+	ClearSlot(Slot);
+
+	CompactSurfaceSamples();
+}
+
+void FHeatCellStore::RemoveOwnerCells(int Handle)
+{
+	for (int Slot : SlotsOf[Handle]) {
+		ClearSlot(Slot);
+	}
+
+	SlotsOf[Handle].Reset();
+
+	CompactSurfaceSamples();
+}
+
+void FHeatCellStore::ClearSlot(int Slot)
+{
+	Phase[Slot] = HeatCellPhase::None;
+	OwnerHandle[Slot] = INDEX_NONE;
+	HitPoints[Slot].Empty();
+	SlotGeneration[Slot]++;
+	NumDeadSurfaceSamples += SurfaceSampleCount[Slot];
+	SurfaceSampleCount[Slot] = 0;
+
+	FreeSlots.Add(Slot);
+}
+
+void FHeatCellStore::RemoveOwner(int Handle)
+{
+	check(Owners.IsValidIndex(Handle) && Owners[Handle]);
+
+	check(SlotsOf[Handle].Num() == 0);
+
+	HandleOf.Remove(Owners[Handle]);
+	Owners[Handle] = nullptr;
+}
+
+bool FHeatCellStore::IsValidSlot(int Slot) const
+{
+	return Phase.IsValidIndex(Slot) && Phase[Slot] != HeatCellPhase::None;
+}
+
+int FHeatCellStore::GetNumSlots() const
+{
+	return Phase.Num();
+}
+
+void FHeatCellStore::Reset()
+{
+	Owners.Reset();
+	Materials.Reset();
+	FaceHitWeights.Reset();
+	HandleOf.Reset();
+	SlotsOf.Reset();
+	SlotListIndex.Reset();
+	CurrTemperature.Reset();
+	FuelCount.Reset();
+	IsBurning.Reset();
+	OwnerHandle.Reset();
+	MapIndex.Reset();
+	CoreIdx.Reset();
+	Phase.Reset();
+	RadiationArea.Reset();
+	HeatDamageApplied.Reset();
+	HeatDamageReceived.Reset();
+	IgnitionCore.Reset();
+	HitQueryCount.Reset();
+	HitQueryAttempts.Reset();
+	HitQueryInFlight.Reset();
+	HitPoints.Reset();
+	Occupancy.Reset();
+	SurfaceSampleStart.Reset();
+	SurfaceSampleCount.Reset();
+	SurfaceSamples.Reset();
+	NumDeadSurfaceSamples = 0;
+	FreeSlots.Reset();
+
+	// 비운 뒤에도 요청 중인 트레이스가 새 셀에 들어가지 않도록 세대만 올립니다.
+	for (uint8& Generation : SlotGeneration) {
+		Generation++;
+	}
+}
+
+void FHeatCellStore::ReceiveHeat(int Slot, float HeatEnergy, float UpdateInterval)
+{
+	ApplyReceivedHeat(Slot, ComputeReceivedHeat(HeatEnergy, UpdateInterval, GetMaterial(Slot).HeatAbsorbRate));
 }
 
-void FHeatBoxInfo::ReceiveHeat(float HeatEnergy, float UpdateInterval)
+float FHeatCellStore::ComputeReceivedHeat(float HeatEnergy, float UpdateInterval, float HeatAbsorbRate)
 {
-	HeatDamageReceived = (HeatEnergy * UpdateInterval) * HeatAbsorbRate;
-	CurrTemperature = CurrTemperature + HeatDamageReceived;
-	CurrTemperature = (CurrTemperature < 20.f) ? 20.f : (CurrTemperature > MaxTemperature) ? MaxTemperature : CurrTemperature;
+	return (HeatEnergy * UpdateInterval) * HeatAbsorbRate;
 }
 
-float FHeatBoxInfo::RadiateHeat()
+void FHeatCellStore::ApplyReceivedHeat(int Slot, float Received)
 {
-	HeatDamageApplied = (Sigma * (pow(MaxTemperature + 273.15f, 4.f) - pow((MaxTemperature - CurrTemperature) + 273.15f, 4.f)) * (RadiationArea / 1e+4) * HeatEmitRate) / 1000.f;
-	return HeatDamageApplied;
+	HeatDamageReceived[Slot] = Received;
+	const float MaxTemperature = GetMaterial(Slot).MaxTemperature;
+	float& Temperature = CurrTemperature[Slot];
+	Temperature = Temperature + Received;
+	Temperature = (Temperature < 20.f) ? 20.f : (Temperature > MaxTemperature) ? MaxTemperature : Temperature;
 }
 
-bool FHeatBoxInfo::IsBurntOut() const
+float FHeatCellStore::RadiateHeat(int Slot)
 {
-	return FuelCount == 0;
+	const FHeatBoxMaterial& Material = GetMaterial(Slot);
+	HeatDamageApplied[Slot] = (Sigma * (pow(Material.MaxTemperature + 273.15f, 4.f) - pow((Material.MaxTemperature - CurrTemperature[Slot]) + 273.15f, 4.f)) * (RadiationArea[Slot] / 1e+4) * Material.HeatEmitRate) / 1000.f;
+	return HeatDamageApplied[Slot];
 }
 
-bool FHeatBoxInfo::IsIgnitionStarting() const
+bool FHeatCellStore::IsBurntOut(int Slot) const
 {
-	return CurrTemperature >= IgnitionPoint;
+	return FuelCount[Slot] == 0;
 }
 
-bool FHeatBoxInfo::IsExtinguished() const
+bool FHeatCellStore::IsIgnitionStarting(int Slot) const
 {
-	return CurrTemperature < IgnitionPoint;
+	return CurrTemperature[Slot] >= GetMaterial(Slot).IgnitionPoint;
 }
 
-FVector FHeatBoxInfo::ClampFireSize(float EstimatedArea) const
+bool FHeatCellStore::IsExtinguished(int Slot) const
 {
+	return CurrTemperature[Slot] < GetMaterial(Slot).IgnitionPoint;
+}
+
+FVector FHeatCellStore::ClampFireSize(int Slot, float EstimatedArea) const
+{
+	const FHeatBoxMaterial& Material = GetMaterial(Slot);
 	EstimatedArea /= 1e+4;
-	EstimatedArea = (EstimatedArea < MinFireSize) ? MinFireSize : (EstimatedArea > MaxFireSize) ? MaxFireSize : EstimatedArea;
+	EstimatedArea = (EstimatedArea < Material.MinFireSize) ? Material.MinFireSize : (EstimatedArea > Material.MaxFireSize) ? Material.MaxFireSize : EstimatedArea;
 
 	return FVector(FVector2D(EstimatedArea), 1.f);
 }
 
+void FHeatCellStore::SetSurfaceSamples(int Slot, const TArray<FVector>& Samples)
+{
+	// 이전 구간에 들어가면 제자리에 덮어쓰고, 아니면 풀 끝에 붙입니다.
+	if (Samples.Num() <= SurfaceSampleCount[Slot]) {
+		NumDeadSurfaceSamples += SurfaceSampleCount[Slot] - Samples.Num();
+		FMemory::Memcpy(SurfaceSamples.GetData() + SurfaceSampleStart[Slot], Samples.GetData(), Samples.Num() * sizeof(FVector));
+	}
+	else {
+		NumDeadSurfaceSamples += SurfaceSampleCount[Slot];
+		SurfaceSampleStart[Slot] = SurfaceSamples.Num();
+		SurfaceSamples.Append(Samples);
+	}
+	SurfaceSampleCount[Slot] = Samples.Num();
+
+	CompactSurfaceSamples();
+
+	if (Samples.Num() > 0) {
+		HitQueryCount[Slot] = 0;
+	}
+}
+
+void FHeatCellStore::CompactSurfaceSamples()
+{
+	if (NumDeadSurfaceSamples * 2 <= SurfaceSamples.Num()) {
+		return;
+	}
+
+	// 시작 위치 순서대로 앞으로 당기므로 제자리 이동으로 충분합니다.
+	TArray<int> LiveSlots;
+	for (int Slot = 0; Slot < SurfaceSampleCount.Num(); Slot++) {
+		if (IsValidSlot(Slot) && SurfaceSampleCount[Slot] > 0) {
+			LiveSlots.Add(Slot);
+		}
+	}
+	LiveSlots.Sort([this](int A, int B) { return SurfaceSampleStart[A] < SurfaceSampleStart[B]; });
+
+	int NumLive = 0;
+	for (int Slot : LiveSlots) {
+		const int Count = SurfaceSampleCount[Slot];
+		if (SurfaceSampleStart[Slot] != NumLive) {
+			FMemory::Memmove(SurfaceSamples.GetData() + NumLive, SurfaceSamples.GetData() + SurfaceSampleStart[Slot], Count * sizeof(FVector));
+			SurfaceSampleStart[Slot] = NumLive;
+		}
+		NumLive += Count;
+	}
+
+	SurfaceSamples.SetNum(NumLive, false);
+	NumDeadSurfaceSamples = 0;
+}
+
+TConstArrayView<FVector> FHeatCellStore::GetHitPoints(int Slot) const
+{
+	if (SurfaceSampleCount[Slot] > 0) {
+		return TConstArrayView<FVector>(SurfaceSamples.GetData() + SurfaceSampleStart[Slot], SurfaceSampleCount[Slot]);
+	}
+
+	return HitPoints[Slot];
+}
+
 // Sets default values
 AHeatmap::AHeatmap()
 {
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	// 시간 분할 모드에서만 틱을 켭니다.
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	FireEffectClass = AFireBlob::StaticClass();
+	bPoolFireEffects = true;
+	FireEffectPoolSize = 16;
+	FireEffectPoolHits = 0;
+	FireEffectPoolMisses = 0;
+	FirePresentation = FirePresentationMode::Actors;
+	InstancedFireSystem = nullptr;
+	FireSizeUpdateThreshold = 0.02f;
+	NumFireSizeUpdates = 0;
+	NumFireSizeUpdatesSkipped = 0;
+	bFireEffectLOD = false;
+	MaxFullQualityFires = 32;
+	FireEffectCullDistance = 10000.f;
+	NumFullQualityFires = 0;
+	NumPausedFires = 0;
+	NumHiddenFires = 0;
 
 	Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root Component"));
 	RootComponent = Root;
@@ -136,10 +456,46 @@ AHeatmap::AHeatmap()
 	UnitSpacings = { 100.f, 100.f, 100.f };
 	HeatTransferRate = 0.16f;
 	UpdateInterval = 1.f;
+	SolverType = DiffusionSolver::Relaxation;
+	bParallelDiffuse = false;
+	NumDiffuseSlabs = 0;
+	bAsyncSimulation = false;
+	bTimeSlicedSimulation = false;
+	TimeSliceBudgetMs = 1.f;
+	PipelineStage = SimPipelineStage::Idle;
+	SliceCursor = 0;
+	bSparseDiffusion = false;
+	ActiveBrickThreshold = 1e-3f;
+	NumActiveBricks = 0;
+	bBakeSurfaceSamples = true;
+	bComputeCellOccupancy = false;
+	bAutoRegisterActors = false;
+	BakedRegistry = nullptr;
+	bValidateBakedActors = false;
+	HitQuerySampling = HitQuerySamplerType::Random;
+	NumHitQueryTraces = 0;
+	NumHitQueryHits = 0;
+	HitQueryAttemptsPerHit = 0.f;
+	MaxHitQueriesPerUpdate = 0;
+	HitQueryBudgetRemaining = MAX_int32;
+	HitQueriesLastUpdate = 0;
+	HitQueryQueueDepth = 0;
+	HitQueryBudgetUtilization = 0.f;
+	bAsyncHitQueries = false;
+	MaxInFlightHitQueries = 256;
+	NumInFlightHitQueries = 0;
+	DiffuseTolerance = 1e-4f;
+	MinDiffuseIterations = 20;
+	MaxDiffuseIterations = 40;
+	LastDiffuseIterations = 0;
+	LastDiffuseResidual = 0.f;
 #if WITH_EDITOR
+	bValidateParallelDiffuse = false;
+	DiffuseValidationTolerance = 1e-2f;
 	bShowTemperatureLog = false;
 	bShowMiscLog = false;
 	ShowHeatMap = VisualVerbosity::Visual_None;
+	HeatVizQuantization = 1.f;
 #endif
 	bSimHasBegun = false;
 
@@ -164,25 +520,103 @@ void AHeatmap::BeginPlay()
 	Super::BeginPlay();
 	Apply();
 	bSimHasBegun = true;
+
+	if (BakedRegistry) {
+		RegisterNewBoxOwners();
+	}
+
+	if (bAutoRegisterActors) {
+		ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &AHeatmap::OnActorSpawned));
+	}
+}
+
+void AHeatmap::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// 진행 중인 백그라운드 시뮬레이션이 this를 참조하지 않도록 기다립니다.
+	if (HeatSimTask.IsValid()) {
+		HeatSimTask.Wait();
+		HeatSimTask = TFuture<void>();
+	}
+
+	if (ActorSpawnedHandle.IsValid()) {
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+		ActorSpawnedHandle.Reset();
+	}
+	PendingSpawnedActors.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AHeatmap::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (SimulationStage == SimStage::Playing && PipelineStage != SimPipelineStage::Idle) {
+		AdvancePipeline();
+	}
 }
 
 void AHeatmap::RegisterNewBoxOwners()
 {
-	RegisterNewBoxOwners_Impl(FlamBoxInstsOf, BurnBoxInstsOf, HeatBoxAt);
+	// 구운 레지스트리가 현재 레벨과 일치하면 겹침 쿼리를 건너뜁니다.
+	if (BakedRegistry && LoadBakedRegistry(FlamBoxInstsOf, HeatBoxAt, CellStore)) {
+		if (bValidateBakedActors) {
+			RegisterUnbakedActors();
+		}
+		return;
+	}
+
+	RegisterNewBoxOwners_Impl(FlamBoxInstsOf, BurnBoxInstsOf, HeatBoxAt, CellStore);
 }
 
 void AHeatmap::ClearRegistry()
 {
+	for (AActor* BoxOwner : CellStore.Owners) {
+		if (BoxOwner) {
+			BoxOwner->OnDestroyed.RemoveDynamic(this, &AHeatmap::OnBoxOwnerDestroyed);
+		}
+	}
+
 	FlamBoxInstsOf.Reset();
 	BurnBoxInstsOf.Reset();
 	HeatBoxAt.Reset();
-	RegisteredBowOwners.Reset();
+	CellStore.Reset();
+}
+
+void AHeatmap::GetRegisteredBoxOwners(TArray<AActor*>& OutBoxOwners) const
+{
+	OutBoxOwners.Reset(CellStore.GetNumOwners());
+	for (AActor* BoxOwner : CellStore.Owners) {
+		if (BoxOwner) {
+			OutBoxOwners.Add(BoxOwner);
+		}
+	}
 }
 
 void AHeatmap::StartSim()
 {
 	if (SimulationStage == SimStage::None) {
 		GetWorldTimerManager().SetTimer(HeatmapTimer, this, &AHeatmap::RouteUpdateHeatmap, UpdateInterval, true, 0);
+		SetActorTickEnabled(bTimeSlicedSimulation);
+		ResetHitQueryStats();
+
+		FireEffectPoolHits = 0;
+		FireEffectPoolMisses = 0;
+
+		if (FirePresentation == FirePresentationMode::Instanced) {
+			if (!FireInstances) {
+				FireInstances = NewObject<UFireInstanceComponent>(this, TEXT("Fire Instances"));
+				FireInstances->SetupAttachment(Root);
+				FireInstances->RegisterComponent();
+			}
+
+			FireInstances->SetAsset(InstancedFireSystem);
+		}
+
+		else {
+			PrewarmFireEffects();
+		}
+
 		SimulationStage = SimStage::Playing;
 	}
 	
@@ -201,11 +635,22 @@ void AHeatmap::PauseSim()
 		GoingFires.GenerateValueArray(FiresToPause);
 		
 		for (auto FireToPause : FiresToPause) {
-			FireToPause->FireEffect->PauseFireEffect();
+			if (FireToPause->FireEffect) {
+				FireToPause->FireEffect->PauseFireEffect();
+				if (FireToPause->EffectLOD == FireEffectLOD::Full) {
+					FireToPause->EffectLOD = FireEffectLOD::Paused;
+				}
+			}
 		}
 
 		for (auto OrphanedFire : OrphanedFires) {
-			OrphanedFire->FireEffect->PauseFireEffect();
+			if (OrphanedFire->FireEffect) {
+				OrphanedFire->FireEffect->PauseFireEffect();
+			}
+		}
+
+		if (FireInstances) {
+			FireInstances->SetPaused(true);
 		}
 
 		SimulationStage = SimStage::Paused;
@@ -221,6 +666,13 @@ void AHeatmap::ResumeSim()
 {
 	if (SimulationStage == SimStage::Paused) {
 		GetWorldTimerManager().UnPauseTimer(HeatmapTimer);
+
+		if (FireInstances) {
+			FireInstances->SetPaused(false);
+		}
+
+		UpdateFireEffectLOD();
+
 		SimulationStage = SimStage::Playing;
 	}
 
@@ -235,9 +687,26 @@ void AHeatmap::EndSim()
 	if ((uint8)SimulationStage > (uint8)SimStage::None) {
 		// 초기화
 		GetWorldTimerManager().ClearTimer(HeatmapTimer);
+
+		// 진행 중인 수치 연산 결과는 버립니다.
+		if (HeatSimTask.IsValid()) {
+			HeatSimTask.Wait();
+			HeatSimTask = TFuture<void>();
+		}
+
+		SetActorTickEnabled(false);
+		PipelineStage = SimPipelineStage::Idle;
+		SliceSlots.Reset();
+		SliceSlotGenerations.Reset();
+		SliceOwners.Reset();
+
 		HeatGenField.Init(0.f, HeatGenField.Num());
+		PendingHeatInputs.Reset();
+		Solver.ResetBricks();
 		GoingFires.Reset();
 		OrphanedFires.Reset();
+		PendingFireSizes.Reset();
+		FlushFireInstances();
 
 		SimulationStage = SimStage::None;
 	}
@@ -250,862 +719,1527 @@ void AHeatmap::EndSim()
 
 void AHeatmap::GetHBParam(AActor* BoxOwner, SetHeatBoxFuncParamType ParamType, float& ParamValue)
 {
+	const int OwnerHandle = CellStore.FindOwner(BoxOwner);
+	if (OwnerHandle == INDEX_NONE) {
+		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+		return;
+	}
+
+	const FHeatBoxMaterial& Material = CellStore.Materials[OwnerHandle];
+
 	switch (ParamType)
 	{
 	case (SetHeatBoxFuncParamType::MaxTemperature):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+		ParamValue = Material.MaxTemperature;
+		break;
 
-			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxTemperature;
+	case (SetHeatBoxFuncParamType::IgnitionPoint):
+		ParamValue = Material.IgnitionPoint;
+		break;
 
-					}
-				}
+	case (SetHeatBoxFuncParamType::HeatAbsorbRate):
+		ParamValue = Material.HeatAbsorbRate;
+		break;
 
-			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = BurnBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxTemperature;
-					
-				}
+	case (SetHeatBoxFuncParamType::HeatEmitRate):
+		ParamValue = Material.HeatEmitRate;
+		break;
+
+	case (SetHeatBoxFuncParamType::FuelCount):
+		// 연료는 셀마다 소모되므로 등록된 셀의 남은 연료를 반환합니다.
+		ParamValue = Material.FuelCount;
+
+		if (FlamBoxInstsOf.Contains(BoxOwner)) {
+			if (FlamBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				ParamValue = CellStore.FuelCount[FlamBoxInstsOf[BoxOwner].Slots[0]];
 			}
 		}
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
+		if (BurnBoxInstsOf.Contains(BoxOwner)) {
+			if (BurnBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				ParamValue = CellStore.FuelCount[BurnBoxInstsOf[BoxOwner].Slots[0]];
+			}
 		}
 		break;
 
-	case (SetHeatBoxFuncParamType::IgnitionPoint):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+	case (SetHeatBoxFuncParamType::MaxFireSize):
+		ParamValue = Material.MaxFireSize;
+		break;
 
-			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].IgnitionPoint;
-					
-				}
-			}
-			
-			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].IgnitionPoint;
-					
-				}
-			}
-		}
+	case (SetHeatBoxFuncParamType::MinFireSize):
+		ParamValue = Material.MinFireSize;
+		break;
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
-		}
+	default:
 		break;
+	}
+}
 
-	case (SetHeatBoxFuncParamType::HeatAbsorbRate):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+void AHeatmap::SetHBParam(AActor* BoxOwner, SetHeatBoxFuncParamType ParamType, float UserValue)
+{
+	const int OwnerHandle = CellStore.FindOwner(BoxOwner);
+	if (OwnerHandle == INDEX_NONE) {
+		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+		return;
+	}
+
+	FHeatBoxMaterial& Material = CellStore.Materials[OwnerHandle];
+
+	switch (ParamType)
+	{
+		case (SetHeatBoxFuncParamType::MaxTemperature) :
+			Material.MaxTemperature = UserValue;
+			break;
+
+		case (SetHeatBoxFuncParamType::IgnitionPoint):
+			Material.IgnitionPoint = UserValue;
+			break;
+		
+		case (SetHeatBoxFuncParamType::HeatAbsorbRate):
+			Material.HeatAbsorbRate = UserValue;
+			break;
+
+		case (SetHeatBoxFuncParamType::HeatEmitRate):
+			Material.HeatEmitRate = UserValue;
+			break;
+
+		case (SetHeatBoxFuncParamType::FuelCount):
+			// 연료는 셀 상태이므로 등록된 셀에도 반영합니다.
+			Material.FuelCount = UserValue;
 
 			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatAbsorbRate;
-					
+				for (int Slot : FlamBoxInstsOf[BoxOwner].Slots) {
+					CellStore.FuelCount[Slot] = UserValue;
 				}
 			}
 
 			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatAbsorbRate;
-					
+				for (int Slot : BurnBoxInstsOf[BoxOwner].Slots) {
+					CellStore.FuelCount[Slot] = UserValue;
 				}
 			}
-		}
+			break;
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
-		}
-		break;
+		case (SetHeatBoxFuncParamType::MaxFireSize):
+			Material.MaxFireSize = UserValue;
+			break;
 
-	case (SetHeatBoxFuncParamType::HeatEmitRate):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+		case (SetHeatBoxFuncParamType::MinFireSize):
+			Material.MinFireSize = UserValue;
+			break;
 
-			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatEmitRate;
-					
+		default:
+			break;
+	}
+}
+
+void AHeatmap::SetFireOn(AActor* BoxOwner)
+{
+	if (CellStore.FindOwner(BoxOwner) != INDEX_NONE) {
+
+		if (FlamBoxInstsOf.Contains(BoxOwner)) {
+			if (FlamBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				for (int Slot : FlamBoxInstsOf[BoxOwner].Slots) {
+					CellStore.CurrTemperature[Slot] = CellStore.GetMaterial(Slot).IgnitionPoint;
 				}
 			}
+		}
 
-			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatEmitRate;
-					
+		if (BurnBoxInstsOf.Contains(BoxOwner)) {
+			if (BurnBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				for (int Slot : BurnBoxInstsOf[BoxOwner].Slots) {
+					CellStore.CurrTemperature[Slot] = CellStore.GetMaterial(Slot).IgnitionPoint;
 				}
 			}
 		}
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
-		}
-		break;
+		UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
+		StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel2);
+	}
 
-	case (SetHeatBoxFuncParamType::FuelCount):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+	else {
+		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+	}
+}
 
-			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].FuelCount;
-					
+void AHeatmap::AddHeat(FIntVector InMapIndex, float Increment)
+{
+	const int CoreIdx = MapToCoreIndex(InMapIndex);
+	float& CurrentHeat = HeatGenField_Accumulator[CoreIdx];
+	CurrentHeat += Increment;
+
+	PendingHeatInputs.Add(InMapIndex);
+}
+
+void AHeatmap::SetBodyTemperature(AActor* BoxOwner, float Temp)
+{
+	if (CellStore.FindOwner(BoxOwner) != INDEX_NONE) {
+
+		if (FlamBoxInstsOf.Contains(BoxOwner)) {
+			if (FlamBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				for (int Slot : FlamBoxInstsOf[BoxOwner].Slots) {
+					CellStore.CurrTemperature[Slot] = Temp;
 				}
 			}
+		}
 
-			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].FuelCount;
-					
+		if (BurnBoxInstsOf.Contains(BoxOwner)) {
+			if (BurnBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				for (int Slot : BurnBoxInstsOf[BoxOwner].Slots) {
+					CellStore.CurrTemperature[Slot] = Temp;
 				}
 			}
 		}
+	}
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
-		}
-		break;
+	else {
+		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+	}
+}
 
-	case (SetHeatBoxFuncParamType::MaxFireSize):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+float AHeatmap::GetBodyTemperature(AActor* BoxOwner) const
+{
+	float BodyTemperature = 0.f;
+	float NumBoxInsts = FlamBoxInstsOf[BoxOwner].Slots.Num() + BurnBoxInstsOf[BoxOwner].Slots.Num();
 
-			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxFireSize;
-					
+	if (CellStore.FindOwner(BoxOwner) != INDEX_NONE) {
+
+		if (FlamBoxInstsOf.Contains(BoxOwner)) {
+			if (FlamBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				for (int Slot : FlamBoxInstsOf[BoxOwner].Slots) {
+					BodyTemperature += CellStore.CurrTemperature[Slot];
 				}
 			}
+		}
 
-			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxFireSize;
-					
+		if (BurnBoxInstsOf.Contains(BoxOwner)) {
+			if (BurnBoxInstsOf[BoxOwner].Slots.Num() > 0) {
+				for (int Slot : BurnBoxInstsOf[BoxOwner].Slots) {
+					BodyTemperature += CellStore.CurrTemperature[Slot];
 				}
 			}
 		}
+	}
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
+	else {
+		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+	}
+
+	if (NumBoxInsts > 0) {
+		BodyTemperature /= NumBoxInsts;
+	}
+
+	return (BodyTemperature == 0.f) ? 20.f : BodyTemperature; 
+}
+
+void AHeatmap::RegisterNewBoxOwners_Impl(TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
+	TMap<AActor*, FBurningBoxInsts>& OutBurnBoxInstsOf,
+	TMap<FIntVector, FHeatBox>& OutHeatBoxAt,
+	FHeatCellStore& OutCellStore)
+{
+	// 히트맵 전체 범위에서 한 번만 겹침 쿼리를 수행합니다.
+	TArray<AActor*> OverlapActors;
+	GatherFlammableActors(OverlapActors);
+
+	RegisterBoxOwners_Impl(OverlapActors, OutFlamBoxInstsOf, OutHeatBoxAt, OutCellStore);
+}
+
+bool AHeatmap::RegisterBoxOwner(AActor* BoxOwner)
+{
+	if (!IsValid(BoxOwner) || BoxOwner == this || CellStore.FindOwner(BoxOwner) != INDEX_NONE) {
+		return false;
+	}
+
+	TArray<AActor*> BoxOwners = { BoxOwner };
+	RegisterBoxOwners_Impl(BoxOwners, FlamBoxInstsOf, HeatBoxAt, CellStore);
+
+	return CellStore.FindOwner(BoxOwner) != INDEX_NONE;
+}
+
+void AHeatmap::RegisterBoxOwners_Impl(TArray<AActor*>& BoxOwners,
+	TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
+	TMap<FIntVector, FHeatBox>& OutHeatBoxAt,
+	FHeatCellStore& OutCellStore)
+{
+	// 이번 호출 이전에 등록된 액터는 건너뜁니다.
+	const int NumRegisteredOwners = OutCellStore.GetNumOwners();
+
+	BoxOwners.RemoveAll([&](const AActor* Actor) {
+		return OutCellStore.FindOwner(Actor) != INDEX_NONE;
+		});
+
+	// 겹침 쿼리 결과 순서와 무관하게 항상 같은 순서로 병합합니다.
+	BoxOwners.Sort([](const AActor& A, const AActor& B) {
+		return A.GetFName().LexicalLess(B.GetFName());
+		});
+
+	const int NumActors = BoxOwners.Num();
+
+	// 충돌체 목록은 게임 스레드에서 모읍니다.
+	TArray<TArray<UPrimitiveComponent*>> PrimCompsOf;
+	PrimCompsOf.SetNum(NumActors);
+	for (int ActorIndex = 0; ActorIndex < NumActors; ActorIndex++) {
+		BoxOwners[ActorIndex]->GetComponents(PrimCompsOf[ActorIndex]);
+		PrimCompsOf[ActorIndex].RemoveAll([](const UPrimitiveComponent* PrimComp) {
+			return !PrimComp->IsCollisionEnabled() || PrimComp->GetCollisionObjectType() != ECC_GameTraceChannel1;
+			});
+	}
+
+	// 액터마다 하나의 태스크로 복셀화
+	const HeatVoxelizer Voxelizer(GetActorTransform(), NumDepthCells, NumWidthCells, NumHeightCells, 0);
+	TArray<TArray<FIntVector>> MapIndicesOf;
+	TArray<TArray<float>> OccupancyOf;
+	MapIndicesOf.SetNum(NumActors);
+	OccupancyOf.SetNum(NumActors);
+
+	ParallelFor(NumActors, [&](int32 ActorIndex) {
+		TSet<FIntVector> Rasterized;
+		for (const UPrimitiveComponent* PrimComp : PrimCompsOf[ActorIndex]) {
+			Voxelizer.RasterizeCollision(PrimComp, Rasterized, MapIndicesOf[ActorIndex], bComputeCellOccupancy ? &OccupancyOf[ActorIndex] : nullptr);
+		}
+		});
+
+	// 액터 순서대로 병합
+	for (int ActorIndex = 0; ActorIndex < NumActors; ActorIndex++) {
+		AActor* Actor = BoxOwners[ActorIndex];
+		const TArray<FIntVector>& MapIndices = MapIndicesOf[ActorIndex];
+		if (MapIndices.Num() == 0) {
+			continue;
 		}
-		break;
 
-	case (SetHeatBoxFuncParamType::MinFireSize):
-		if (RegisteredBowOwners.Contains(BoxOwner)) {
+		FHeatBoxInfoDefaultInit HeatBoxInfoInit;
 
-			if (FlamBoxInstsOf.Contains(BoxOwner)) {
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].MinFireSize;
-					
-				}
+		const int OwnerHandle = OutCellStore.AddOwner(Actor, FHeatBoxMaterial(HeatBoxInfoInit));
+
+		// 파괴 이벤트는 플레이 중에만 연결합니다.
+		if (bAutoRegisterActors && GetWorld()->IsGameWorld()) {
+			Actor->OnDestroyed.AddUniqueDynamic(this, &AHeatmap::OnBoxOwnerDestroyed);
+		}
+
+		for (int n = 0; n < MapIndices.Num(); n++) {
+			const FIntVector& MapIdx = MapIndices[n];
+			FHeatBox& Found = OutHeatBoxAt.FindOrAdd(MapIdx);
+			if (Found.SlotOf.Contains(Actor)) {
+				continue;
 			}
 
-			if (BurnBoxInstsOf.Contains(BoxOwner)) {
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-					auto Index = FlamBoxInstsOf[BoxOwner].Indices[0];
-					ParamValue = HeatBoxAt[Index].InstInfoOf[BoxOwner].MinFireSize;
-					
-				}
+			const int Slot = OutCellStore.AddCell(MapIdx, MapToCoreIndex(MapIdx), OwnerHandle, HeatBoxInfoInit);
+			Found.SlotOf.Add(Actor, Slot);
+
+			if (bComputeCellOccupancy) {
+				OutCellStore.Occupancy[Slot] = OccupancyOf[ActorIndex][n];
 			}
-		}
 
-		else {
-			ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			
+			OutFlamBoxInstsOf.FindOrAdd(Actor).Slots.Add(Slot);
 		}
-		break;
+	}
 
-	default:
-		break;
+	if (bBakeSurfaceSamples) {
+		BakeSurfaceSamples(NumRegisteredOwners, OutHeatBoxAt, OutCellStore);
 	}
 }
 
-void AHeatmap::SetHBParam(AActor* BoxOwner, SetHeatBoxFuncParamType ParamType, float UserValue)
+void AHeatmap::GatherFlammableActors(TArray<AActor*>& OutActors) const
 {
-	switch (ParamType)
-	{
-		case (SetHeatBoxFuncParamType::MaxTemperature) :
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
-				
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxTemperature = UserValue;
-						}
-					}
-				}
+	OutActors.Reset();
 
-				if(BurnBoxInstsOf.Contains(BoxOwner)) {
-					if(BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxTemperature = UserValue;
-						}
-					}
-				}	
-			}
-			
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			}
-			break;
+	const FVector MapExtent = 50.f * FVector(NumDepthCells, NumWidthCells, NumHeightCells);
+	const FVector MapCenter = GetActorTransform().TransformPosition(MapExtent - FVector(50.f));
 
-		case (SetHeatBoxFuncParamType::IgnitionPoint):
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
+	FCollisionQueryParams CollQueryParams;
+	CollQueryParams.AddIgnoredActor(this);
 
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].IgnitionPoint = UserValue;
-						}
-					}
-				}
+	TArray<FOverlapResult> Overlaps;
+	GetWorld()->OverlapMultiByObjectType(Overlaps, MapCenter, GetActorQuat(), FCollisionObjectQueryParams(ECC_GameTraceChannel1), 
+		FCollisionShape::MakeBox(MapExtent * GetActorScale3D()), CollQueryParams); //ECC_GameTraceChannel1 == 'Firebox'
 
-				if (BurnBoxInstsOf.Contains(BoxOwner)) {
-					if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].IgnitionPoint = UserValue;
-						}
-					}
+	for (const FOverlapResult& Overlap : Overlaps) {
+		if (AActor* Actor = Overlap.GetActor()) {
+			OutActors.AddUnique(Actor);
+		}
+	}
+}
+
+bool AHeatmap::LoadBakedRegistry(TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
+	TMap<FIntVector, FHeatBox>& OutHeatBoxAt,
+	FHeatCellStore& OutCellStore)
+{
+	if (!BakedRegistry->MatchesHeatmap(GetActorTransform(), FIntVector(NumDepthCells, NumWidthCells, NumHeightCells))) {
+		UE_LOG(Firebox, Warning, TEXT("Baked registry %s does not match this heatmap, registering at runtime"), *BakedRegistry->GetName());
+		return false;
+	}
+
+	// 등록 전에 모든 액터를 검증합니다.
+	TArray<AActor*> BakedActors;
+	BakedActors.Reserve(BakedRegistry->BoxOwners.Num());
+
+	for (const FBakedBoxOwner& BakedOwner : BakedRegistry->BoxOwners) {
+		AActor* Actor = ResolveBakedActor(BakedOwner.Actor);
+
+		bool bUpToDate = IsValid(Actor) && Actor->GetActorTransform().Equals(BakedOwner.ActorTransform)
+			&& BakedOwner.CellStart >= 0 && BakedOwner.CellCount >= 0 && BakedOwner.CellCount <= BakedRegistry->CellMapIndex.Num() - BakedOwner.CellStart;
+#if WITH_EDITOR
+		bUpToDate = bUpToDate && Actor->GetActorGuid() == BakedOwner.ActorGuid;
+#endif
+
+		if (!bUpToDate) {
+			UE_LOG(Firebox, Warning, TEXT("Baked registry %s is out of date at %s, registering at runtime"), *BakedRegistry->GetName(), *BakedOwner.Actor.ToString());
+			return false;
+		}
+
+		BakedActors.Add(Actor);
+	}
+
+	// 손상되었거나 다른 격자로 구운 에셋의 셀과 표면 샘플 구간을 걸러냅니다.
+	const int NumBakedSamples = BakedRegistry->SurfaceSamples.Num();
+	for (int Cell = 0; Cell < BakedRegistry->CellMapIndex.Num(); Cell++) {
+		const int SampleStart = BakedRegistry->CellSampleStart[Cell];
+		const int NumSamples = BakedRegistry->CellSampleCount[Cell];
+
+		if (!IsWithinMap(BakedRegistry->CellMapIndex[Cell])
+			|| SampleStart < 0 || NumSamples < 0 || NumSamples > NumBakedSamples - SampleStart) {
+			UE_LOG(Firebox, Warning, TEXT("Baked registry %s has an invalid cell %d, registering at runtime"), *BakedRegistry->GetName(), Cell);
+			return false;
+		}
+	}
+
+	FHeatBoxInfoDefaultInit HeatBoxInfoInit;
+	TArray<FVector> BakedSamples;
+
+	for (int OwnerIndex = 0; OwnerIndex < BakedActors.Num(); OwnerIndex++) {
+		AActor* Actor = BakedActors[OwnerIndex];
+		if (OutCellStore.FindOwner(Actor) != INDEX_NONE) {
+			continue;
+		}
+
+		const FBakedBoxOwner& BakedOwner = BakedRegistry->BoxOwners[OwnerIndex];
+		const int OwnerHandle = OutCellStore.AddOwner(Actor, BakedOwner.Material);
+
+		if (bAutoRegisterActors && GetWorld()->IsGameWorld()) {
+			Actor->OnDestroyed.AddUniqueDynamic(this, &AHeatmap::OnBoxOwnerDestroyed);
+		}
+
+		for (int Cell = BakedOwner.CellStart; Cell < BakedOwner.CellStart + BakedOwner.CellCount; Cell++) {
+			const FIntVector& MapIdx = BakedRegistry->CellMapIndex[Cell];
+
+			const int Slot = OutCellStore.AddCell(MapIdx, MapToCoreIndex(MapIdx), OwnerHandle, HeatBoxInfoInit);
+			OutHeatBoxAt.FindOrAdd(MapIdx).SlotOf.Add(Actor, Slot);
+			OutCellStore.Occupancy[Slot] = BakedRegistry->CellOccupancy[Cell];
+
+			const int SampleStart = BakedRegistry->CellSampleStart[Cell];
+			const int NumSamples = BakedRegistry->CellSampleCount[Cell];
+			if (NumSamples > 0) {
+				BakedSamples.Reset();
+				for (int n = 0; n < NumSamples; n++) {
+					BakedSamples.Add(FVector(BakedRegistry->SurfaceSamples[SampleStart + n]));
 				}
+
+				OutCellStore.SetSurfaceSamples(Slot, BakedSamples);
 			}
 
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+			OutFlamBoxInstsOf.FindOrAdd(Actor).Slots.Add(Slot);
+		}
+	}
+
+	return true;
+}
+
+AActor* AHeatmap::ResolveBakedActor(const TSoftObjectPtr<AActor>& BakedActor) const
+{
+	FSoftObjectPath ActorPath = BakedActor.ToSoftObjectPath();
+
+#if WITH_EDITOR
+	// 에셋에는 에디터 월드 경로가 저장되므로 PIE 월드 경로로 바꿉니다.
+	if (GetWorld()->IsPlayInEditor()) {
+		ActorPath.FixupForPIE(GetOutermost()->GetPIEInstanceID());
+	}
+#endif
+
+	return Cast<AActor>(ActorPath.ResolveObject());
+}
+
+void AHeatmap::RegisterUnbakedActors()
+{
+	TSet<AActor*> BakedActors;
+	BakedActors.Reserve(BakedRegistry->FlammableActors.Num());
+	for (const TSoftObjectPtr<AActor>& BakedActor : BakedRegistry->FlammableActors) {
+		BakedActors.Add(ResolveBakedActor(BakedActor));
+	}
+
+	// 구운 목록에 없는 액터만 남깁니다. 개수만 비교하면 바뀐 액터를 놓칩니다.
+	TArray<AActor*> OverlapActors;
+	GatherFlammableActors(OverlapActors);
+	OverlapActors.RemoveAllSwap([&BakedActors](AActor* Actor) { return BakedActors.Contains(Actor); });
+
+	if (OverlapActors.Num() > 0) {
+		const int NumBakedOwners = CellStore.GetNumOwners();
+		RegisterBoxOwners_Impl(OverlapActors, FlamBoxInstsOf, HeatBoxAt, CellStore);
+
+		UE_LOG(Firebox, Warning, TEXT("Baked registry %s misses %d flammable actors, registered %d at runtime; rebake to skip the overlap query"),
+			*BakedRegistry->GetName(), OverlapActors.Num(), CellStore.GetNumOwners() - NumBakedOwners);
+	}
+}
+
+void AHeatmap::UnregisterBoxOwner(AActor* BoxOwner)
+{
+	const int OwnerHandle = CellStore.FindOwner(BoxOwner);
+	if (OwnerHandle == INDEX_NONE) {
+		return;
+	}
+
+	// 진행 중인 화염은 소유자 없이 소멸하도록 넘깁니다.
+	if (const FBurningBoxInsts* BurningBoxInsts = BurnBoxInstsOf.Find(BoxOwner)) {
+		for (uint64 FireSignature : BurningBoxInsts->FireSignatures) {
+			TSharedPtr<FFireInBox> GoingFire;
+			if (GoingFires.RemoveAndCopyValue(FireSignature, GoingFire)) {
+				OrphanedFires.Add(GoingFire);
 			}
-			break;
-		
-		case (SetHeatBoxFuncParamType::HeatAbsorbRate):
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
+		}
 
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatAbsorbRate = UserValue;
-						}
-					}
-				}
+		// 파괴되지 않은 액터는 연소 전 충돌 채널과 태그로 되돌립니다.
+		if (BurningBoxInsts->Slots.Num() > 0 && IsValid(BoxOwner)) {
+			BoxOwner->Tags.Remove(Burning);
 
-				if (BurnBoxInstsOf.Contains(BoxOwner)) {
-					if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatAbsorbRate = UserValue;
-						}
-					}
-				}
+			if (UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()))) {
+				StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel1);
 			}
+		}
+	}
 
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+	// 연소가 끝난 셀도 포함된 소유자별 슬롯 목록
+	for (int Slot : CellStore.GetOwnerSlots(OwnerHandle)) {
+		const FIntVector MapIdx = CellStore.MapIndex[Slot];
+		if (FHeatBox* HeatBox = HeatBoxAt.Find(MapIdx)) {
+			HeatBox->SlotOf.Remove(BoxOwner);
+			if (HeatBox->SlotOf.Num() == 0) {
+				HeatBoxAt.Remove(MapIdx);
 			}
-			break;
+		}
+	}
 
-		case (SetHeatBoxFuncParamType::HeatEmitRate):
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
+	CellStore.RemoveOwnerCells(OwnerHandle);
 
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatEmitRate = UserValue;
-						}
-					}
-				}
+	FlamBoxInstsOf.Remove(BoxOwner);
+	BurnBoxInstsOf.Remove(BoxOwner);
 
-				if (BurnBoxInstsOf.Contains(BoxOwner)) {
-					if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].HeatEmitRate = UserValue;
-						}
-					}
-				}
-			}
+	HitQueryIgnoredActors.Remove(BoxOwner);
+	HitQueryParamsOf.Remove(BoxOwner);
 
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
-			}
-			break;
+	CellStore.RemoveOwner(OwnerHandle);
 
-		case (SetHeatBoxFuncParamType::FuelCount):
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
+	if (IsValid(BoxOwner)) {
+		BoxOwner->OnDestroyed.RemoveDynamic(this, &AHeatmap::OnBoxOwnerDestroyed);
+	}
+}
 
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].FuelCount = UserValue;
-						}
-					}
-				}
+void AHeatmap::OnActorSpawned(AActor* SpawnedActor)
+{
+	// 스폰 이벤트는 지연 스폰의 FinishSpawning과 블루프린트 구성 스크립트보다 먼저 오므로
+	// 그때 추가되는 충돌체까지 보려면 다음 틱에 등록합니다.
+	if (PendingSpawnedActors.Num() == 0) {
+		GetWorldTimerManager().SetTimerForNextTick(this, &AHeatmap::RegisterSpawnedActors);
+	}
 
-				if (BurnBoxInstsOf.Contains(BoxOwner)) {
-					if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].FuelCount = UserValue;
-						}
-					}
-				}
-			}
+	PendingSpawnedActors.Add(SpawnedActor);
+}
 
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+void AHeatmap::RegisterSpawnedActors()
+{
+	TArray<TWeakObjectPtr<AActor>> SpawnedActors = MoveTemp(PendingSpawnedActors);
+	PendingSpawnedActors.Reset();
+
+	for (const TWeakObjectPtr<AActor>& SpawnedActorPtr : SpawnedActors) {
+		// 등록 전에 파괴된 액터
+		AActor* SpawnedActor = SpawnedActorPtr.Get();
+		if (!IsValid(SpawnedActor)) {
+			continue;
+		}
+
+		// FinishSpawning을 아직 호출하지 않은 지연 스폰 액터
+		if (!SpawnedActor->IsActorInitialized()) {
+			if (PendingSpawnedActors.Num() == 0) {
+				GetWorldTimerManager().SetTimerForNextTick(this, &AHeatmap::RegisterSpawnedActors);
 			}
-			break;
+			PendingSpawnedActors.Add(SpawnedActor);
+			continue;
+		}
 
-		case (SetHeatBoxFuncParamType::MaxFireSize):
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
+		// 화염 이펙트 등 히트맵이 스폰한 액터는 가연성 충돌체가 없으므로 래스터화 전에 걸러집니다.
+		TArray<UPrimitiveComponent*> PrimComps;
+		SpawnedActor->GetComponents(PrimComps);
 
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxFireSize = UserValue;
-						}
-					}
-				}
+		const bool bFlammable = PrimComps.ContainsByPredicate([](const UPrimitiveComponent* PrimComp) {
+			return PrimComp->IsCollisionEnabled() && PrimComp->GetCollisionObjectType() == ECC_GameTraceChannel1;
+			});
 
-				if (BurnBoxInstsOf.Contains(BoxOwner)) {
-					if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].MaxFireSize = UserValue;
-						}
-					}
-				}
-			}
+		if (bFlammable) {
+			RegisterBoxOwner(SpawnedActor);
+		}
+	}
+}
 
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+void AHeatmap::OnBoxOwnerDestroyed(AActor* DestroyedActor)
+{
+	UnregisterBoxOwner(DestroyedActor);
+}
+
+void AHeatmap::BakeSurfaceSamples(int FirstOwnerHandle, const TMap<FIntVector, FHeatBox>& InHeatBoxAt, FHeatCellStore& OutCellStore) const
+{
+	TMap<FIntVector, TArray<FVector>> SamplesAt;
+
+	for (int OwnerHandle = FirstOwnerHandle; OwnerHandle < OutCellStore.GetNumOwners(); OwnerHandle++) {
+		AActor* BoxOwner = OutCellStore.Owners[OwnerHandle];
+		if (!BoxOwner) {
+			continue;
+		}
+
+		// 액터 전체를 덮도록 모든 스태틱 메쉬 컴포넌트를 합칩니다.
+		HeatVoxelizer Voxelizer(GetActorTransform(), NumDepthCells, NumWidthCells, NumHeightCells, HITQUERY_REQ);
+
+		TArray<UStaticMeshComponent*> StaticMeshComps;
+		BoxOwner->GetComponents(StaticMeshComps);
+
+		bool bSampled = false;
+		for (const UStaticMeshComponent* StaticMeshComp : StaticMeshComps) {
+			bSampled |= Voxelizer.AddStaticMesh(StaticMeshComp);
+		}
+
+		if (!bSampled) {
+			continue;
+		}
+
+		Voxelizer.GetSurfaceSamples(SamplesAt);
+
+		for (const auto& SampleAt : SamplesAt) {
+			const FHeatBox* HeatBox = InHeatBoxAt.Find(SampleAt.Key);
+			const int* Slot = HeatBox ? HeatBox->SlotOf.Find(BoxOwner) : nullptr;
+			if (Slot) {
+				OutCellStore.SetSurfaceSamples(*Slot, SampleAt.Value);
 			}
-			break;
+		}
+	}
+}
 
-		case (SetHeatBoxFuncParamType::MinFireSize):
-			if (RegisteredBowOwners.Contains(BoxOwner)) {
+void AHeatmap::Apply()
+{
+	UnitSpacings = 100 * GetActorScale3D();
+	
+	HeatGenField.Init(0., (NumDepthCells + 2) * (NumWidthCells + 2) * (NumHeightCells + 2));
 
-				if (FlamBoxInstsOf.Contains(BoxOwner)) {
-					if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].MinFireSize = UserValue;
-						}
-					}
+	HeatGenField_Accumulator.Init(0., (NumDepthCells + 2) * (NumWidthCells + 2) * (NumHeightCells + 2));
+
+	Solver = HeatSolver(NumDepthCells, NumWidthCells, NumHeightCells, HeatTransferRate);
+
+	if (SolverType == DiffusionSolver::Multigrid) {
+		Multigrid = HeatMultigrid(NumDepthCells, NumWidthCells, NumHeightCells, HeatTransferRate);
+	}
+
+	UMaterialInstanceDynamic* DynVizColor = UMaterialInstanceDynamic::Create(VizColor, this);
+	GraphViz->SetMaterial(0, DynVizColor);
+	
+#if WITH_EDITOR	
+	TArray<FTransform> Transforms;
+	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
+		Transforms.Empty(NumDepthCells * NumWidthCells * NumHeightCells);
+	}
+
+	// 셀 컴포넌트는 디버그 시각화에만 만듭니다. 액터 등록은 셀 컴포넌트 없이 HeatVoxelizer::RasterizeCollision이 담당합니다.
+	for (int i = 0; i < NumDepthCells; i++) {
+		for (int j = 0; j < NumWidthCells; j++) {
+			for (int k = 0; k < NumHeightCells; k++) {
+				FVector CompRelLoc(100.f * i, 100.f * j, 100.f * k);
+
+				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatGrid) {
+					UBoxComponent* HeatCell = Cast<UBoxComponent>(AddComponentByClass(UBoxComponent::StaticClass(), false, FTransform(CompRelLoc), false));
+					HeatCell->SetBoxExtent(FVector{ 50. }); // 1m^3 in Unreal
+					HeatCell->SetLineThickness(3.0f);
+					HeatCell->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+					HeatCell->SetGenerateOverlapEvents(false);
 				}
 
-				if (BurnBoxInstsOf.Contains(BoxOwner)) {
-					if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-						for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-							HeatBoxAt[Index].InstInfoOf[BoxOwner].MinFireSize = UserValue;
-						}
-					}
+				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
+					Transforms.Emplace(FVector(100.f * i, 100.f * j, 100.f * k));
 				}
-			}
 
-			else {
-				ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatValue) {
+					AddComponentByClass(UTextRenderComponent::StaticClass(), false, FTransform(FRotator(0., 180., 0.), CompRelLoc + FVector(0., -25., -15.)), false);
+				}
 			}
-			break;
+		}
+	}
 
-		default:
-			break;
+	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
+		GraphViz->AddInstances(Transforms, false, false);
 	}
+#endif
 }
 
-void AHeatmap::SetFireOn(AActor* BoxOwner)
+void AHeatmap::BakeRegistry()
 {
-	if (RegisteredBowOwners.Contains(BoxOwner)) {
+#if WITH_EDITOR
+	if (!BakedRegistry) {
+		UE_LOG(Firebox, Warning, TEXT("Assign a registry asset to bake into"));
+		return;
+	}
 
-		if (FlamBoxInstsOf.Contains(BoxOwner)) {
-			if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-				for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-					HeatBoxAt[Index].InstInfoOf[BoxOwner].CurrTemperature = HeatBoxAt[Index].InstInfoOf[BoxOwner].IgnitionPoint;
-				}
-			}
+	// 현재 레지스트리는 건드리지 않고 임시 레지스트리에 등록합니다.
+	TMap<AActor*, FFlammableBoxInsts> BakeFlamBoxInstsOf;
+	TMap<FIntVector, FHeatBox> BakeHeatBoxAt;
+	FHeatCellStore BakeCellStore;
+	TArray<AActor*> OverlapActors;
+	GatherFlammableActors(OverlapActors);
+
+	// RegisterBoxOwners_Impl이 목록을 거르고 정렬하므로 먼저 기록합니다.
+	TArray<TSoftObjectPtr<AActor>> FlammableActors(OverlapActors);
+
+	RegisterBoxOwners_Impl(OverlapActors, BakeFlamBoxInstsOf, BakeHeatBoxAt, BakeCellStore);
+
+	BakedRegistry->Modify();
+	BakedRegistry->Reset();
+	BakedRegistry->HeatmapTransform = GetActorTransform();
+	BakedRegistry->NumCells = FIntVector(NumDepthCells, NumWidthCells, NumHeightCells);
+	BakedRegistry->FlammableActors = MoveTemp(FlammableActors);
+
+	for (int OwnerHandle = 0; OwnerHandle < BakeCellStore.GetNumOwners(); OwnerHandle++) {
+		AActor* BoxOwner = BakeCellStore.Owners[OwnerHandle];
+		const FFlammableBoxInsts* FlammableBoxInsts = BakeFlamBoxInstsOf.Find(BoxOwner);
+		if (!FlammableBoxInsts) {
+			continue;
 		}
 
-		if (BurnBoxInstsOf.Contains(BoxOwner)) {
-			if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-				for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-					HeatBoxAt[Index].InstInfoOf[BoxOwner].CurrTemperature = HeatBoxAt[Index].InstInfoOf[BoxOwner].IgnitionPoint;
-				}
+		FBakedBoxOwner& BakedOwner = BakedRegistry->BoxOwners.AddDefaulted_GetRef();
+		BakedOwner.Actor = BoxOwner;
+		BakedOwner.ActorGuid = BoxOwner->GetActorGuid();
+		BakedOwner.ActorTransform = BoxOwner->GetActorTransform();
+		BakedOwner.Material = BakeCellStore.Materials[OwnerHandle];
+		BakedOwner.CellStart = BakedRegistry->CellMapIndex.Num();
+		BakedOwner.CellCount = FlammableBoxInsts->Slots.Num();
+
+		for (int Slot : FlammableBoxInsts->Slots) {
+			BakedRegistry->CellMapIndex.Add(BakeCellStore.MapIndex[Slot]);
+			BakedRegistry->CellOccupancy.Add(BakeCellStore.Occupancy[Slot]);
+			BakedRegistry->CellSampleStart.Add(BakedRegistry->SurfaceSamples.Num());
+			BakedRegistry->CellSampleCount.Add(BakeCellStore.SurfaceSampleCount[Slot]);
+
+			const int SampleStart = BakeCellStore.SurfaceSampleStart[Slot];
+			for (int n = 0; n < BakeCellStore.SurfaceSampleCount[Slot]; n++) {
+				BakedRegistry->SurfaceSamples.Add(FVector3f(BakeCellStore.SurfaceSamples[SampleStart + n]));
 			}
 		}
+	}
 
-		UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
-		StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel2);
+	BakedRegistry->MarkPackageDirty();
+
+	UE_LOG(Firebox, Log, TEXT("Baked %d actors, %d cells and %d surface samples into %s"),
+		BakedRegistry->BoxOwners.Num(), BakedRegistry->CellMapIndex.Num(), BakedRegistry->SurfaceSamples.Num(), *BakedRegistry->GetName());
+#endif
+}
+
+void AHeatmap::RouteUpdateHeatmap()
+{
+	// 이전 틱의 백그라운드 결과를 반영하고 PostUpdate를 마칩니다.
+	CompleteHeatSimTask();
+
+	if (bTimeSlicedSimulation) {
+		BeginPipelineStep();
+	}
+
+	else if (bAsyncSimulation) {
+		PreUpdateHeatmap();
+		UpdateFires();
+		LaunchHeatSimTask();
 	}
 
 	else {
-		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+		PreUpdateHeatmap();
+		UpdateHeatmap();
+		PostUpdateHeatmap();
 	}
 }
 
-void AHeatmap::AddHeat(FIntVector InMapIndex, float Increment)
+
+void AHeatmap::TraceBoxOwner(int Slot, int& CurrentHitCount, ECollisionChannel BoxType)
 {
-	const int CoreIdx = MapToCoreIndex(InMapIndex);
-	float& CurrentHeat = HeatGenField_Accumulator[CoreIdx];
-	CurrentHeat += Increment;
+	// BurningActor의 스테틱 메쉬 랜덤 표면에 이펙트를 스폰합니다. 
+	FHitResult HitResult;
+	FVector TraceStart;
+	FVector TraceEnd;
+	const int Face = GetHitQuerySegment(Slot, CellStore.HitQueryAttempts[Slot]++, TraceStart, TraceEnd);
+
+	FCollisionObjectQueryParams CollObjQueryParams;
+	CollObjQueryParams.AddObjectTypesToQuery(BoxType);
+
+	GetWorld()->LineTraceSingleByObjectType(HitResult, TraceStart, TraceEnd, CollObjQueryParams, GetHitQueryParams(Slot));
+
+	const bool bHit = ProcessHitQuery(Slot, HitResult);
+	RecordHitQuery(Slot, Face, bHit);
+
+	if (bHit) {
+		--CurrentHitCount;
+	}
 }
 
-void AHeatmap::SetBodyTemperature(AActor* BoxOwner, float Temp)
+int AHeatmap::GetHitQuerySegment(int Slot, uint32 SampleIndex, FVector& OutStart, FVector& OutEnd)
 {
-	if (RegisteredBowOwners.Contains(BoxOwner)) {
+	const FIntVector BoxIndex = CellStore.MapIndex[Slot];
 
-		if (FlamBoxInstsOf.Contains(BoxOwner)) {
-			if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-				for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-					HeatBoxAt[Index].InstInfoOf[BoxOwner].CurrTemperature = Temp;
-				}
+	FVector BoxRelPos;
+	GetMapWorldPos(BoxIndex, BoxRelPos);
+
+	int Face = INDEX_NONE;
+	FVector TrajNode1 = BoxRelPos;
+	FVector TrajNode2;
+
+	if (HitQuerySampling == HitQuerySamplerType::Stratified) {
+		const uint32 Scramble = HitQuerySampler::CellScramble(BoxIndex);
+		const float* FaceWeights = &CellStore.FaceHitWeights[CellStore.OwnerHandle[Slot] * HitQuerySampler::NumFaces];
+
+		Face = HitQuerySampler::PickFace(FaceWeights, HitQuerySampler::RadicalInverse3(SampleIndex, (Scramble >> 8) / 16777216.f));
+		TrajNode2 = BoxFacePoint(BoxRelPos, UnitSpacings, (BoxFaces)Face, HitQuerySampler::Sobol2D(SampleIndex, Scramble));
+	}
+
+	else {
+		TrajNode2 = RandRangeFromBoxSurface(BoxRelPos, UnitSpacings) + (10. * FMath::VRand());
+	}
+
+	//int SelectInt = FMath::RandRange(0, 1);
+	int SelectInt = 1;
+
+	if (SelectInt == 0) {
+		OutStart = TrajNode1; // 중심에서 박스 표면 방향
+		OutEnd = TrajNode2;
+	}
+	else {
+		OutStart = TrajNode2; // 박스 표면에서 중심 방향
+		OutEnd = TrajNode1;
+	}
+
+	return Face;
+}
+
+void AHeatmap::RecordHitQuery(int Slot, int Face, bool bHit)
+{
+	NumHitQueryTraces++;
+
+	if (bHit) {
+		NumHitQueryHits++;
+
+		// 히트가 난 면을 이후 샘플에서 더 자주 고릅니다.
+		if (Face != INDEX_NONE) {
+			CellStore.FaceHitWeights[CellStore.OwnerHandle[Slot] * HitQuerySampler::NumFaces + Face] += 1.f;
+		}
+	}
+
+	HitQueryAttemptsPerHit = (NumHitQueryHits > 0) ? (float)NumHitQueryTraces / NumHitQueryHits : 0.f;
+}
+
+void AHeatmap::ResetHitQueryStats()
+{
+	NumHitQueryTraces = 0;
+	NumHitQueryHits = 0;
+	HitQueryAttemptsPerHit = 0.f;
+}
+
+const FCollisionQueryParams& AHeatmap::GetHitQueryParams(int Slot)
+{
+	const AActor* BoxOwner = CellStore.GetBoxOwner(Slot);
+	if (const FCollisionQueryParams* Found = HitQueryParamsOf.Find(BoxOwner)) {
+		return *Found;
+	}
+
+	// 소유자를 제외한 연소 액터 무시 (트레이스 패스 동안 소유자마다 한 번)
+	FCollisionQueryParams& QueryParams = HitQueryParamsOf.Add(BoxOwner);
+	for (const AActor* BurningActor : HitQueryIgnoredActors) {
+		if (BurningActor != BoxOwner) {
+			QueryParams.AddIgnoredActor(BurningActor);
+		}
+	}
+
+#if WITH_EDITOR
+	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Trace) {
+		QueryParams.TraceTag = FName("Debug Trace");
+	}
+#endif
+
+	return QueryParams;
+}
+
+bool AHeatmap::ProcessHitQuery(int Slot, const FHitResult& HitResult)
+{
+	if (!HitResult.bBlockingHit || CellStore.GetBoxOwner(Slot) != HitResult.GetActor()) {
+		return false;
+	}
+
+#if WITH_EDITOR
+	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Trace) {
+		// 충돌된 오브젝트 표면을 표시합니다.
+		DrawDebugSphere(GetWorld(), HitResult.Location, 1., 12, FColor::Magenta, false, 1., 5.);
+	}		
+#endif			
+	CellStore.HitPoints[Slot].Add(HitResult.Location);
+/*
+#if WITH_EDITOR
+	if (bShowLogMsg) {
+	// 라인 트레이싱 결과를 출력합니다.
+	UE_LOG(LogTemp, Warning, TEXT("%s"), *HitResult.ToString());
+	}
+#endif
+*/
+	return true;
+}
+
+void AHeatmap::IssueHitQueries(int Slot, ECollisionChannel BoxType)
+{
+	const int NumToIssue = FMath::Min(FMath::Min3(
+		CellStore.HitQueryCount[Slot] - CellStore.HitQueryInFlight[Slot],
+		HITQUERY_TOLERANCE - CellStore.HitQueryAttempts[Slot],
+		MaxInFlightHitQueries - NumInFlightHitQueries),
+		HitQueryBudgetRemaining);
+
+	if (NumToIssue <= 0) {
+		return;
+	}
+
+	HitQueryBudgetRemaining -= NumToIssue;
+
+	if (!HitQueryDelegate.IsBound()) {
+		HitQueryDelegate.BindUObject(this, &AHeatmap::OnHitQueryCompleted);
+	}
+
+	// 한 셀의 요청은 같은 충돌 파라미터를 공유합니다.
+	FCollisionObjectQueryParams CollObjQueryParams;
+	CollObjQueryParams.AddObjectTypesToQuery(BoxType);
+	const FCollisionQueryParams& CollQueryParams = GetHitQueryParams(Slot);
+
+	check(Slot < (1 << HITQUERY_SLOT_BITS));
+	const uint32 Generation = CellStore.SlotGeneration[Slot] & ((1u << HITQUERY_GEN_BITS) - 1);
+
+	for (int n = 0; n < NumToIssue; n++) {
+		FVector TraceStart;
+		FVector TraceEnd;
+		const int Face = GetHitQuerySegment(Slot, CellStore.HitQueryAttempts[Slot] + n, TraceStart, TraceEnd);
+
+		// 사용자 데이터: 하위 24비트 슬롯, 다음 3비트 면 + 1, 상위 5비트 슬롯 세대
+		const uint32 UserData = (uint32)Slot | ((uint32)(Face + 1) << HITQUERY_SLOT_BITS) | (Generation << (HITQUERY_SLOT_BITS + 3));
+		GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, TraceStart, TraceEnd, CollObjQueryParams, CollQueryParams, &HitQueryDelegate, UserData);
+	}
+
+	CellStore.HitQueryAttempts[Slot] += NumToIssue;
+	CellStore.HitQueryInFlight[Slot] += NumToIssue;
+	NumInFlightHitQueries += NumToIssue;
+}
+
+void AHeatmap::OnHitQueryCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	NumInFlightHitQueries = FMath::Max(0, NumInFlightHitQueries - 1);
+
+	// 요청 이후 등록 취소되었거나 시뮬레이션이 끝난 셀. 슬롯이 다른 셀에 재사용되었으면 세대가 다릅니다.
+	const int Slot = (int)(TraceDatum.UserData & ((1u << HITQUERY_SLOT_BITS) - 1));
+	const int Face = (int)((TraceDatum.UserData >> HITQUERY_SLOT_BITS) & 7) - 1;
+	const uint32 Generation = TraceDatum.UserData >> (HITQUERY_SLOT_BITS + 3);
+	if (!CellStore.IsValidSlot(Slot) || CellStore.HitQueryInFlight[Slot] <= 0
+		|| Generation != (CellStore.SlotGeneration[Slot] & ((1u << HITQUERY_GEN_BITS) - 1))) {
+		return;
+	}
+
+	CellStore.HitQueryInFlight[Slot]--;
+
+	const bool bHit = CellStore.HitQueryCount[Slot] > 0 && TraceDatum.OutHits.Num() > 0 && ProcessHitQuery(Slot, TraceDatum.OutHits[0]);
+	RecordHitQuery(Slot, Face, bHit);
+
+	if (bHit) {
+		CellStore.HitQueryCount[Slot]--;
+	}
+}
+
+void AHeatmap::BeginHitQueryPass(TArray<int>& InOutSlots)
+{
+	HitQueryBudgetRemaining = (MaxHitQueriesPerUpdate > 0) ? MaxHitQueriesPerUpdate : MAX_int32;
+
+	// 이번 패스의 무시 목록. 연소 액터 집합은 위상 변화 단계에서만 바뀝니다.
+	HitQueryParamsOf.Reset();
+	BurnBoxInstsOf.GenerateKeyArray(HitQueryIgnoredActors);
+
+#if WITH_EDITOR
+	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Trace) {
+		GetWorld()->DebugDrawTraceTag = FName("Debug Trace");
+	}
+#endif
+
+	// 예산이 없으면 순서가 의미 없습니다.
+	if (MaxHitQueriesPerUpdate <= 0) {
+		return;
+	}
+
+	FVector FocusLocation = FVector::ZeroVector;
+	const APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(this, 0);
+	if (PlayerPawn) {
+		FocusLocation = PlayerPawn->GetActorLocation();
+	}
+
+	struct FHitQueryOrder
+	{
+		int Slot;
+		bool bNewlyIgnited;
+		double DistSquared;
+	};
+
+	TArray<FHitQueryOrder> Orders;
+	Orders.Reserve(InOutSlots.Num());
+	for (int Slot : InOutSlots) {
+		FVector BoxWorldPos;
+		GetMapWorldPos(CellStore.MapIndex[Slot], BoxWorldPos);
+
+		// 아직 한 번도 트레이스하지 않은 셀 = 새로 점화된 셀
+		Orders.Add({ Slot, CellStore.HitQueryAttempts[Slot] == 0, PlayerPawn ? FVector::DistSquared(BoxWorldPos, FocusLocation) : 0. });
+	}
+
+	// 새로 점화된 셀, 플레이어에 가까운 셀 순
+	Orders.StableSort([](const FHitQueryOrder& A, const FHitQueryOrder& B) {
+		if (A.bNewlyIgnited != B.bNewlyIgnited) {
+			return A.bNewlyIgnited;
+		}
+		return A.DistSquared < B.DistSquared;
+		});
+
+	for (int n = 0; n < Orders.Num(); n++) {
+		InOutSlots[n] = Orders[n].Slot;
+	}
+}
+
+void AHeatmap::EndHitQueryPass(const TArray<int>& Slots)
+{
+	// 히트가 부족해 다음 업데이트로 넘어가는 셀
+	HitQueryQueueDepth = 0;
+	for (int Slot : Slots) {
+		if (CellStore.IsValidSlot(Slot) && CellStore.IsBurning[Slot] && CellStore.HitQueryCount[Slot] > 0) {
+			HitQueryQueueDepth++;
+		}
+	}
+
+	if (MaxHitQueriesPerUpdate > 0) {
+		HitQueriesLastUpdate = MaxHitQueriesPerUpdate - HitQueryBudgetRemaining;
+		HitQueryBudgetUtilization = (float)HitQueriesLastUpdate / MaxHitQueriesPerUpdate;
+	}
+
+	else {
+		HitQueriesLastUpdate = MAX_int32 - HitQueryBudgetRemaining;
+		HitQueryBudgetUtilization = 0.f;
+	}
+
+	HitQueryBudgetRemaining = MAX_int32;
+
+	HitQueryParamsOf.Reset();
+	HitQueryIgnoredActors.Reset();
+}
+
+void AHeatmap::UnregisterBurningCell(int Slot)
+{
+	AActor* BoxOwner = CellStore.GetBoxOwner(Slot);
+	const FIntVector BurningBoxIndex = CellStore.MapIndex[Slot];
+
+	BurnBoxInstsOf[BoxOwner].Slots.Remove(Slot);
+	HeatBoxAt[BurningBoxIndex].SlotOf.Remove(BoxOwner);
+	
+	if (HeatBoxAt[BurningBoxIndex].SlotOf.Num() == 0) {
+		HeatBoxAt.Remove(BurningBoxIndex);
+	}
+
+	CellStore.RemoveCell(Slot);
+}
+		
+// UpdateInterval 간격의 업데이트 로직을 담고있는 함수입니다.
+void AHeatmap::PreUpdateHeatmap()
+{
+	UpdatePhaseTransitions();
+
+	TArray<int> BurningSlots;
+	GatherBurningBoxes(BurningSlots);
+	BeginHitQueryPass(BurningSlots);
+
+	for (int Slot : BurningSlots) {
+		TraceBurningBox(Slot);
+	}
+
+	EndHitQueryPass(BurningSlots);
+}
+
+void AHeatmap::UpdatePhaseTransitions()
+{
+	// 순회 중에는 위상 변화만 기록합니다.
+	PhaseTransitions.Reset();
+
+	for (auto& InstOf : FlamBoxInstsOf) {
+		for (int Slot : InstOf.Value.Slots) {
+			if (CellStore.IsIgnitionStarting(Slot)) {
+				PhaseTransitions.Emplace(Slot, HeatCellPhase::Burning);
 			}
 		}
+	}
 
-		if (BurnBoxInstsOf.Contains(BoxOwner)) {
-			if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-				for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-					HeatBoxAt[Index].InstInfoOf[BoxOwner].CurrTemperature = Temp;
+	for (auto& InstOf : BurnBoxInstsOf) {
+		for (int Slot : InstOf.Value.Slots) {
+			if (CellStore.IsBurntOut(Slot)) {
+				PhaseTransitions.Emplace(Slot, HeatCellPhase::BurntOut);
+			}
+
+			else if (CellStore.IsExtinguished(Slot)) {
+				PhaseTransitions.Emplace(Slot, HeatCellPhase::Flammable);
+			}
+		}
+	}
+
+	if (PhaseTransitions.Num() > 0) {
+		ApplyPhaseTransitions();
+	}
+}
+
+void AHeatmap::ApplyPhaseTransitions()
+{
+	// 액터별 소화 여부
+	TMap<AActor*, bool> TransitionOwners;
+
+	for (const FHeatCellTransition& Transition : PhaseTransitions) {
+		const int Slot = Transition.Slot;
+		AActor* BoxOwner = CellStore.GetBoxOwner(Slot);
+		bool& bExtinguished = TransitionOwners.FindOrAdd(BoxOwner, false);
+
+		// 위상 변화
+		switch (Transition.NewPhase)
+		{
+		case HeatCellPhase::Burning:
+		{
+			BoxOwner->Tags.AddUnique(Burning);
+			BurnBoxInstsOf.FindOrAdd(BoxOwner).Slots.Add(Slot);
+
+			UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
+			StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel2);
+
+			CellStore.IsBurning[Slot] = true;
+			break;
+		}
+
+		case HeatCellPhase::BurntOut:
+			BoxOwner->Tags.AddUnique(BurntOut);
+			break;
+
+		case HeatCellPhase::Flammable:
+			FlamBoxInstsOf.FindOrAdd(BoxOwner).Slots.Add(Slot);
+			CellStore.IsBurning[Slot] = false;
+			bExtinguished = true;
+			break;
+
+		default:
+			break;
+		}
+
+		CellStore.Phase[Slot] = Transition.NewPhase;
+	}
+
+	// 압축: 위상이 바뀐 슬롯을 레지스트리에서 한 번에 제거합니다.
+	for (auto& TransitionOwner : TransitionOwners) {
+		AActor* BoxOwner = TransitionOwner.Key;
+
+		if (FFlammableBoxInsts* FlammableBoxInsts = FlamBoxInstsOf.Find(BoxOwner)) {
+			const int NumRemoved = FlammableBoxInsts->Slots.RemoveAll([&](int Slot) {
+				return CellStore.Phase[Slot] != HeatCellPhase::Flammable;
+				});
+
+			if (NumRemoved > 0 && FlammableBoxInsts->Slots.Num() == 0) {
+				BoxOwner->Tags.Remove("Flammable");
+			}
+		}
+
+		if (FBurningBoxInsts* BurningBoxInsts = BurnBoxInstsOf.Find(BoxOwner)) {
+			const int NumRemoved = BurningBoxInsts->Slots.RemoveAll([&](int Slot) {
+				return CellStore.Phase[Slot] != HeatCellPhase::Burning;
+				});
+
+			if (NumRemoved > 0 && BurningBoxInsts->Slots.Num() == 0) {
+				BoxOwner->Tags.Remove("Burning");
+
+				if (TransitionOwner.Value) {
+					UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
+					StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel1);
 				}
 			}
 		}
 	}
+}
 
-	else {
-		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+void AHeatmap::GatherBurningBoxes(TArray<int>& OutBurningSlots) const
+{
+	OutBurningSlots.Reset();
+	for (auto& InstOf : BurnBoxInstsOf) {
+		OutBurningSlots.Append(InstOf.Value.Slots);
 	}
 }
 
-float AHeatmap::GetBodyTemperature(AActor* BoxOwner) const
+void AHeatmap::TraceBurningBox(int Slot)
 {
-	float BodyTemperature = 0.f;
-	float NumBoxInsts = FlamBoxInstsOf[BoxOwner].Indices.Num() + BurnBoxInstsOf[BoxOwner].Indices.Num();
+	// 이전 단계에서 등록 취소되었거나 더 이상 연소 중이 아닌 셀
+	if (!CellStore.IsValidSlot(Slot) || !CellStore.IsBurning[Slot] || CellStore.IsBurntOut(Slot)) {
+		return;
+	}
 
-	if (RegisteredBowOwners.Contains(BoxOwner)) {
+	int& CurrentHitQueryCount = CellStore.HitQueryCount[Slot];
 
-		if (FlamBoxInstsOf.Contains(BoxOwner)) {
-			if (FlamBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-				for (auto Index : FlamBoxInstsOf[BoxOwner].Indices) {
-					BodyTemperature += HeatBoxAt[Index].InstInfoOf[BoxOwner].CurrTemperature;
-				}
-			}
+	if (bAsyncHitQueries) {
+		if (CurrentHitQueryCount <= 0) {
+			return;
 		}
 
-		if (BurnBoxInstsOf.Contains(BoxOwner)) {
-			if (BurnBoxInstsOf[BoxOwner].Indices.Num() > 0) {
-				for (auto Index : BurnBoxInstsOf[BoxOwner].Indices) {
-					BodyTemperature += HeatBoxAt[Index].InstInfoOf[BoxOwner].CurrTemperature;
-				}
+		// 허용 횟수를 모두 요청했고 결과도 모두 돌아왔는데 히트가 부족하면 등록 취소
+		if (CellStore.HitQueryAttempts[Slot] >= HITQUERY_TOLERANCE) {
+			if (CellStore.HitQueryInFlight[Slot] == 0) {
+				UnregisterBurningCell(Slot);
 			}
+			return;
 		}
-	}
 
-	else {
-		ensureMsgf(0, TEXT("An Actor(%s) is not registered"), *BoxOwner->GetName());
+		IssueHitQueries(Slot, ECC_GameTraceChannel2);
+		return;
 	}
 
-	if (NumBoxInsts > 0) {
-		BodyTemperature /= NumBoxInsts;
-	}
+	while (CurrentHitQueryCount > 0) {
+		
+		if (CellStore.HitQueryAttempts[Slot] >= HITQUERY_TOLERANCE) {
+/*
+#if WITH_EDITOR
+			if (bShowLogMsg) {
+				UE_LOG(Firebox, Error, TEXT("Hit query attempt at %d (out of %d) exceeded the limit of %d"), HITQUERY_REQ -CurrentHitQueryCount, HITQUERY_REQ, HITQUERY_TOLERANCE);
+			}
+#endif
+*/						
+			// 등록 취소
+			UnregisterBurningCell(Slot);
 
-	return (BodyTemperature == 0.f) ? 20.f : BodyTemperature; 
+			break;
+		}
+
+		// 예산을 다 쓰면 남은 시도는 다음 업데이트로 이월합니다.
+		if (HitQueryBudgetRemaining <= 0) {
+			break;
+		}
+
+		HitQueryBudgetRemaining--;
+		TraceBoxOwner(Slot, CurrentHitQueryCount, ECC_GameTraceChannel2);
+	} //ECC_GameTraceChannel1 == 'Firebox'
 }
 
-void AHeatmap::RegisterNewBoxOwners_Impl(TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
-	TMap<AActor*, FBurningBoxInsts>& OutBurnBoxInstsOf,
-	TMap<FIntVector, FHeatBox>& OutHeatBoxAt)
+void AHeatmap::UpdateHeatmap()
 {
-	TArray<UBoxComponent*> HeatCells;
-	GetComponents(HeatCells);
+	UpdateFires();
 
-	for (auto HeatCell : HeatCells) {
-		TArray<AActor*> OverlapActors;
-
-		TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes = { UCollisionProfile::Get()->ConvertToObjectType(ECC_GameTraceChannel1) };
-		TArray<AActor*> ActorsToIgnore = {};
+	AccumulateHeat(HeatGenField, HeatGenField_Accumulator);
+	
+	// 히트필드 업데이트
+	FlushHeatInputs();
 
-		UKismetSystemLibrary::ComponentOverlapActors(HeatCell, HeatCell->GetComponentTransform(), ObjectTypes, NULL, ActorsToIgnore, OverlapActors);
+	FHeatDiffuseStats DiffuseStats;
+	Diffuse(HeatGenField, GetDiffuseSettings(), DiffuseStats);
+	ApplyDiffuseStats(DiffuseStats);
 
-		if (OverlapActors.Num() > 0) {
+	UpdateHeatVisuals();
 
-			for (auto Actor : OverlapActors) {
+	ApplyHeatDamage();
+}
 
-				if (RegisteredBowOwners.Contains(Actor))
-					continue;
+void AHeatmap::UpdateFires()
+{
+	BeginFireAggregation();
 
-				FIntVector MapIdx;
+	for (auto& InstOf : BurnBoxInstsOf) {
+		AggregateFiresOf(InstOf.Key);
+	}
 
-				GetMapIndex(HeatCell->GetRelativeLocation(), MapIdx);
+	EndFireAggregation();
+}
 
-				if (FFlammableBoxInsts* Found = OutFlamBoxInstsOf.Find(Actor)) {
-					Found->Indices.AddUnique(MapIdx);
-				}
-				else {
-					OutFlamBoxInstsOf.Emplace(Actor, FFlammableBoxInsts());
-					OutFlamBoxInstsOf[Actor].Indices.Add(MapIdx);
-				}
+void AHeatmap::BeginFireAggregation()
+{
+	FireGeneration++;
+}
 
-				FHeatBoxInfoDefaultInit HeatBoxInfoInit;
+void AHeatmap::AggregateFiresOf(AActor* BoxOwner)
+{
+	// 화염 확산/축소 로직
+	FBurningBoxInsts* BurningBoxInsts = BurnBoxInstsOf.Find(BoxOwner);
+	if (!BurningBoxInsts) {
+		return;
+	}
 
-				FHeatBox& Found = OutHeatBoxAt.FindOrAdd(MapIdx);
-				Found.InstInfoOf.Add(Actor, FHeatBoxInfo(HeatBoxInfoInit));
-			}
-		}
+	const TArray<int>& BurningSlots = BurningBoxInsts->Slots;
+	BurningBoxInsts->FireSignatures.Reset();
 
-		if (HeatCell == HeatCells.Last()) {
-			for (auto& InstOf : FlamBoxInstsOf) {
-				AActor* BoxOwner = InstOf.Key;
-				if (RegisteredBowOwners.Contains(BoxOwner) == false) {
-					RegisteredBowOwners.Add(BoxOwner);
-				}
-			}
-		}
+	// 각 연소 오브젝트의 현재 화염 확산 범위 (X/Y 4-이웃 연결 요소)
+	TArray<FIntVector> BurningBoxIndices;
+	BurningBoxIndices.Reserve(BurningSlots.Num());
+	for (int Slot : BurningSlots) {
+		BurningBoxIndices.Add(CellStore.MapIndex[Slot]);
 	}
-}
 
-void AHeatmap::Apply()
-{
-	UnitSpacings = 100 * GetActorScale3D();
-	
-	HeatGenField.Init(0., (NumDepthCells + 2) * (NumWidthCells + 2) * (NumHeightCells + 2));
+	const int NumRegions = RegionLabeler.Label(BurningBoxIndices);
+	if (NumRegions == 0) {
+		return;
+	}
 
-	HeatGenField_Accumulator.Init(0., (NumDepthCells + 2) * (NumWidthCells + 2) * (NumHeightCells + 2));
+	// 같은 셀을 공유하는 다른 소유자의 화염 범위와 구분합니다.
+	const uint64 OwnerSeed = FireRegionLabeler::Mix((uint64)CellStore.OwnerHandle[BurningSlots[0]]);
 
-	UMaterialInstanceDynamic* DynVizColor = UMaterialInstanceDynamic::Create(VizColor, this);
-	GraphViz->SetMaterial(0, DynVizColor);
-	
-#if WITH_EDITOR	
-	TArray<FTransform> Transforms;
-	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
-		Transforms.Empty(NumDepthCells * NumWidthCells * NumHeightCells);
-	}
-#endif
+	for (int Region = 0; Region < NumRegions; Region++) {
+		const TConstArrayView<int> RegionElements = RegionLabeler.GetRegion(Region);
+		const uint64 Signature = RegionLabeler.GetRegionSignature(Region) ^ OwnerSeed;
+		BurningBoxInsts->FireSignatures.Add(Signature);
 
-	for (int i = 0; i < NumDepthCells; i++) {
-		for (int j = 0; j < NumWidthCells; j++) {
-			for (int k = 0; k < NumHeightCells; k++) {
-				FVector CompRelLoc(100.f * i, 100.f * j, 100.f * k);
+		RegionHitPoints.Reset();
+		for (int Element : RegionElements) {
+			const TConstArrayView<FVector> HitPoints = CellStore.GetHitPoints(BurningSlots[Element]);
+			RegionHitPoints.Append(HitPoints.GetData(), HitPoints.Num());
+		}
 
-				UBoxComponent* HeatCell = Cast<UBoxComponent>(AddComponentByClass(UBoxComponent::StaticClass(), false, FTransform(CompRelLoc), false));
-				HeatCell->SetBoxExtent(FVector{ 50. }); // 1m^3 in Unreal
-				HeatCell->SetLineThickness(3.0f);
-				HeatCell->SetCollisionResponseToAllChannels(ECR_Ignore);
-				HeatCell->SetCollisionResponseToChannel(ECC_GameTraceChannel1, ECR_Overlap); //ECC_GameTraceChannel1 == 'Firebox'
+		const int Slot = BurningSlots[RegionElements[0]];
 
-				HeatCell->SetVisibility(false);
-				HeatCell->bHiddenInGame = 1;
+		FVector BoxWorldPos;
+		GetMapWorldPos(BurningBoxIndices[RegionElements[0]], BoxWorldPos);
 
+		PointEstimator PtEstimator;
 #if WITH_EDITOR	
-				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatGrid) {
-					HeatCell->SetVisibility(true);
-					HeatCell->bHiddenInGame = 0;
-				}
+		if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Estimator) {
+			PointEstimator Temp_PtEstimator(RegionHitPoints, GetWorld(), BoxWorldPos.Z);
+			PtEstimator = Temp_PtEstimator;
+		}
+		
+		else {
+			PointEstimator Temp_PtEstimator(RegionHitPoints);
+			PtEstimator = Temp_PtEstimator;
+		}
+#else
+		PointEstimator Temp_PointEstimator(RegionHitPoints);
+		PtEstimator = Temp_PointEstimator;
+#endif
+		FVector2D EstimatedCenter = PtEstimator.EstimateCenter2D();
+		float EstimateCenterPosZ = PtEstimator.EstimateCenterPosZ();
+		float EstimatedArea = PtEstimator.EstimateArea2D();
 
-				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
-					Transforms.Emplace(FVector(100.f * i, 100.f * j, 100.f * k));
-				}
+		// 현재 화염 확산 범위와 기존 화염 확산 범위를 비교 및 업데이트
+		TSharedPtr<FFireInBox>* GoingFire = GoingFires.Find(Signature);
+		if (!GoingFire) {
+			TArray<FIntVector> AggregateIndices;
+			TArray<int> AggregateSlots;
+			AggregateIndices.Reserve(RegionElements.Num());
+			AggregateSlots.Reserve(RegionElements.Num());
+			for (int Element : RegionElements) {
+				AggregateIndices.Add(BurningBoxIndices[Element]);
+				AggregateSlots.Add(BurningSlots[Element]);
+			}
 
-				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatValue) {
-					AddComponentByClass(UTextRenderComponent::StaticClass(), false, FTransform(FRotator(0., 180., 0.), CompRelLoc + FVector(0., -25., -15.)), false);
-				}
-#endif
+			// 현재 화염 범위 생성
+			TSharedPtr<FFireInBox> NewFire = MakeShared<FFireInBox>(Signature, AggregateIndices, AggregateSlots);
+			NewFire->SpawnLocation = FVector(EstimatedCenter, EstimateCenterPosZ);
+			
+			// 이펙트 최초 생성 
+			NewFire->SpawnSize = CellStore.ClampFireSize(Slot, EstimatedArea);
+
+			if (FirePresentation == FirePresentationMode::Actors) {
+				NewFire->FireEffect = AcquireFireEffect(FTransform(FRotator(), NewFire->SpawnLocation, NewFire->SpawnSize));
+				NewFire->EffectPool = this;
 			}
+
+			GoingFire = &GoingFires.Add(Signature, NewFire);
 		}
-	}
 
-#if WITH_EDITOR	
-	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
-		GraphViz->AddInstances(Transforms, false, false);
+		(*GoingFire)->Generation = FireGeneration;
+
+		// 연소로 인해 방출된 열에너지를 히트맵에 반영합니다.
+		for (int Element : RegionElements) {
+			const int AggregateSlot = BurningSlots[Element];
+			float& CurrentHeat = HeatGenField[CellStore.CoreIdx[AggregateSlot]];
+			
+			CellStore.RadiationArea[AggregateSlot] = EstimatedArea;
+			CellStore.IgnitionCore[AggregateSlot] = FVector(EstimatedCenter, EstimateCenterPosZ);
+			
+			float RadiatedHeatEnergy = CellStore.RadiateHeat(AggregateSlot);
+			CurrentHeat += RadiatedHeatEnergy;
+
+			PendingHeatInputs.Add(CellStore.MapIndex[AggregateSlot]);
+		}
 	}
-#endif
 }
 
-void AHeatmap::RouteUpdateHeatmap()
+AFireBlob* AHeatmap::AcquireFireEffect(const FTransform& SpawnTransform)
 {
-	PreUpdateHeatmap();
-	UpdateHeatmap();
-	PostUpdateHeatmap();
-}
+	while (bPoolFireEffects && PooledFireEffects.Num() > 0) {
+		AFireBlob* FireEffect = PooledFireEffects.Pop(false);
+
+		// 블루프린트에서 직접 파괴한 이펙트는 버립니다.
+		if (IsValid(FireEffect)) {
+			FireEffect->ReuseFromPool(SpawnTransform);
+			FireEffectPoolHits++;
+			return FireEffect;
+		}
+	}
 
+	FireEffectPoolMisses++;
+	return GetWorld()->SpawnActor<AFireBlob>(FireEffectClass, SpawnTransform);
+}
 
-void AHeatmap::TraceBoxOwner(const FIntVector& BoxIndex, AActor* const BoxOwner, int& CurrentHitCount, ECollisionChannel BoxType)
+void AHeatmap::ReleaseFireEffect(AFireBlob* FireEffect)
 {
-	FVector BoxRelPos;
-	GetMapWorldPos(BoxIndex, BoxRelPos);
+	if (!IsValid(FireEffect)) {
+		return;
+	}
 
-	// BurningActor의 스테틱 메쉬 랜덤 표면에 이펙트를 스폰합니다. 
-	FHitResult HitResult;
-	FVector TrajNode1 = BoxRelPos;
-	FVector TrajNode2 = RandRangeFromBoxSurface(BoxRelPos, UnitSpacings) + (10. * FMath::VRand());
-	TArray<FVector> HitTrajectory;
+	if (!bPoolFireEffects) {
+		FireEffect->Destroy();
+		return;
+	}
 
-	//int SelectInt = FMath::RandRange(0, 1);
-	int SelectInt = 1;
+	FireEffect->ReturnToPool();
+	PooledFireEffects.Add(FireEffect);
+}
 
-	if (SelectInt == 0) {
-		HitTrajectory = { TrajNode1, TrajNode2 }; // 중심에서 박스 표면 방향
-	}
-	else {
-		HitTrajectory = { TrajNode2, TrajNode1 }; // 박스 표면에서 중심 방향
+void AHeatmap::PrewarmFireEffects()
+{
+	if (!bPoolFireEffects) {
+		return;
 	}
 
-	FCollisionObjectQueryParams CollObjQueryParams;
-	CollObjQueryParams.AddObjectTypesToQuery(BoxType);
-	
-	FCollisionQueryParams CollQueryParams;
-	TArray<AActor*> BurningActors;
-	BurnBoxInstsOf.GenerateKeyArray(BurningActors);
-	BurningActors.Remove(BoxOwner);
-
-	CollQueryParams.AddIgnoredActors(BurningActors);
+	PooledFireEffects.RemoveAll([](const AFireBlob* FireEffect) { return !IsValid(FireEffect); });
 
-#if WITH_EDITOR
-	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Trace) {
-		const FName TraceTag("Debug Trace");
-		GetWorld()->DebugDrawTraceTag = TraceTag;
-		CollQueryParams.TraceTag = TraceTag;
-	}
-#endif
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
 
-	GetWorld()->LineTraceSingleByObjectType(HitResult, HitTrajectory[0], HitTrajectory[1], CollObjQueryParams, CollQueryParams);
+	while (PooledFireEffects.Num() < FireEffectPoolSize) {
+		AFireBlob* FireEffect = GetWorld()->SpawnActor<AFireBlob>(FireEffectClass, GetActorTransform(), SpawnParams);
+		if (!FireEffect) {
+			break;
+		}
 
-	if (HitResult.bBlockingHit) {
-		if (BoxOwner == HitResult.GetActor()) {
+		FireEffect->ReturnToPool();
+		PooledFireEffects.Add(FireEffect);
+	}
+}
 
-#if WITH_EDITOR
-			if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Trace) {
-				// 충돌된 오브젝트 표면을 표시합니다.
-				DrawDebugSphere(GetWorld(), HitResult.Location, 1., 12, FColor::Magenta, false, 1., 5.);
-			}		
-#endif			
-			HeatBoxAt[BoxIndex].InstInfoOf[BoxOwner].HitPoints.AddUnique(HitResult.Location);
-/*
-#if WITH_EDITOR
-			if (bShowLogMsg) {
-			// 라인 트레이싱 결과를 출력합니다.
-			UE_LOG(LogTemp, Warning, TEXT("%s"), *HitResult.ToString());
-			}
-#endif
-*/
-			--CurrentHitCount;
+void AHeatmap::ApplyFireSizes()
+{
+	NumFireSizeUpdates = 0;
+	NumFireSizeUpdatesSkipped = PendingFireSizesSkipped;
+	PendingFireSizesSkipped = 0;
+
+	for (const TPair<uint64, float>& PendingFireSize : PendingFireSizes) {
+		if (const TSharedPtr<FFireInBox>* GoingFire = GoingFires.Find(PendingFireSize.Key)) {
+			(*GoingFire)->SetFireSize(PendingFireSize.Value);
+			NumFireSizeUpdates++;
 		}
 	}
+
+	PendingFireSizes.Reset();
 }
-		
-// UpdateInterval 간격의 업데이트 로직을 담고있는 함수입니다.
-void AHeatmap::PreUpdateHeatmap()
+
+void AHeatmap::UpdateFireEffectLOD()
 {
-	TMap<AActor*, FFlammableBoxInsts> Temp_FlamBoxInstsOf = FlamBoxInstsOf;
-	for (auto& InstOf : Temp_FlamBoxInstsOf) {
-		AActor* BoxOwner = InstOf.Key;
-		const TArray<FIntVector>& FlammableBoxIndices = InstOf.Value.Indices;
-		for (FIntVector FlammableBoxIndex : FlammableBoxIndices) {
-			FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[FlammableBoxIndex].InstInfoOf[BoxOwner];
-			const float CurrTemperature = HeatBoxInfo.CurrTemperature;
-			const float IgnitionPoint = HeatBoxInfo.IgnitionPoint;
-			
-			if (HeatBoxInfo.IsIgnitionStarting()) {
-				BoxOwner->Tags.AddUnique(Burning);
+	if (!bFireEffectLOD || FirePresentation != FirePresentationMode::Actors) {
+		return;
+	}
 
-				// 위상 변화
-				BurnBoxInstsOf.FindOrAdd(BoxOwner).Indices.Add(FlammableBoxIndex);
-				
-				UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
-				StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel2);
-				
-				FlamBoxInstsOf[BoxOwner].Indices.Remove(FlammableBoxIndex);
-				HeatBoxInfo.IsBurning = true;
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (auto PlayerController = GetWorld()->GetPlayerControllerIterator(); PlayerController; ++PlayerController) {
+		if (const APlayerController* Viewer = PlayerController->Get()) {
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			Viewer->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
 
-				if (FlamBoxInstsOf[BoxOwner].Indices.Num() == 0)
-				{
-					BoxOwner->Tags.Remove("Flammable");
-				}
-			}
-		}	
+	// 시점이 없으면 모든 화염을 그대로 둡니다.
+	if (ViewLocations.Num() == 0) {
+		return;
 	}
 
-	TMap<AActor*, FBurningBoxInsts> Temp_BurnBoxInstsOf = BurnBoxInstsOf;
-	for (auto& InstOf : Temp_BurnBoxInstsOf) {
-		AActor* BoxOwner = InstOf.Key;
-		const TArray<FIntVector>& BurningBoxIndices = InstOf.Value.Indices;
-		for (FIntVector BurningBoxIndex : BurningBoxIndices) {
-			FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[BurningBoxIndex].InstInfoOf[BoxOwner];
-			int& CurrentHitQueryCount = HeatBoxInfo.HitQueryCount;
-			
-			if (HeatBoxInfo.IsBurntOut()) {
-				BoxOwner->Tags.AddUnique(BurntOut);
-				// 위상 변화
-				BurnBoxInstsOf[BoxOwner].Indices.Remove(BurningBoxIndex);				
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() == 0) {
-					BoxOwner->Tags.Remove("Burning");
+	// 화면 크기 근사: 화염 크기 / 가장 가까운 시점까지의 거리 (컬링 거리 밖은 음수)
+	FireSignificance.Reset();
+	for (const auto& GoingFire : GoingFires) {
+		const FFireInBox& Fire = *GoingFire.Value;
+		if (!Fire.FireEffect) {
+			continue;
+		}
 
-				}
-			}
+		double MinDistSquared = MAX_dbl;
+		for (const FVector& ViewLocation : ViewLocations) {
+			MinDistSquared = FMath::Min(MinDistSquared, FVector::DistSquared(ViewLocation, Fire.SpawnLocation));
+		}
 
-			else if (HeatBoxInfo.IsExtinguished()) {
-				
-				// 위상 변화
-				FlamBoxInstsOf.FindOrAdd(BoxOwner).Indices.Add(BurningBoxIndex);
+		const double Distance = FMath::Sqrt(MinDistSquared);
+		const float Significance = (Distance > FireEffectCullDistance) ? -1.f : (float)(100. * Fire.SpawnSize.GetMax() * Fire.FireSize / FMath::Max(Distance, 1.));
+		FireSignificance.Emplace(GoingFire.Key, Significance);
+	}
 
-				BurnBoxInstsOf[BoxOwner].Indices.Remove(BurningBoxIndex);
-				HeatBoxInfo.IsBurning = false;
+	FireSignificance.Sort([](const TPair<uint64, float>& A, const TPair<uint64, float>& B) {
+		return A.Value > B.Value;
+		});
 
-				if (BurnBoxInstsOf[BoxOwner].Indices.Num() == 0) {
-					BoxOwner->Tags.Remove("Burning");
-					
-					UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
-					StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel1);
-				}
-			}
+	NumFullQualityFires = 0;
+	NumPausedFires = 0;
+	NumHiddenFires = 0;
 
-			else {
-				for (int i = 0; CurrentHitQueryCount > 0; ++i) {
-					
-					if (i >= HITQUERY_TOLERANCE) {
-/*
-#if WITH_EDITOR
-						if (bShowLogMsg) {
-							UE_LOG(Firebox, Error, TEXT("Hit query attempt at %d (out of %d) exceeded the limit of %d"), HITQUERY_REQ -CurrentHitQueryCount, HITQUERY_REQ, HITQUERY_TOLERANCE);
-						}
-#endif
-*/						
-						// 등록 취소
-						BurnBoxInstsOf[BoxOwner].Indices.Remove(BurningBoxIndex);
-						HeatBoxAt[BurningBoxIndex].InstInfoOf.Remove(BoxOwner);
-						
-						if (HeatBoxAt[BurningBoxIndex].InstInfoOf.Num() == 0) {
-							HeatBoxAt.Remove(BurningBoxIndex);
-						}
-
-						break;
-					}
+	for (const TPair<uint64, float>& Significance : FireSignificance) {
+		FFireInBox& Fire = *GoingFires[Significance.Key];
 
-					TraceBoxOwner(BurningBoxIndex, BoxOwner, CurrentHitQueryCount, ECC_GameTraceChannel2);
-				} //ECC_GameTraceChannel1 == 'Firebox'
+		if (Significance.Value < 0.f) {
+			Fire.SetEffectLOD(FireEffectLOD::Hidden);
+			NumHiddenFires++;
+		}
 
-				/*UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(BoxOwner->GetComponentByClass(UStaticMeshComponent::StaticClass()));
-				StaticMeshComp->SetCollisionObjectType(ECC_GameTraceChannel3);*/
-			}
+		else if (NumFullQualityFires < MaxFullQualityFires) {
+			Fire.SetEffectLOD(FireEffectLOD::Full);
+			NumFullQualityFires++;
+		}
+
+		else {
+			Fire.SetEffectLOD(FireEffectLOD::Paused);
+			NumPausedFires++;
 		}
 	}
 }
 
-void AHeatmap::UpdateHeatmap()
+void AHeatmap::FlushFireInstances()
 {
-	// 화염 확산/축소 로직
-	TMultiMap<AActor*, TSharedPtr<FFireInBox>> NewGoingFires;
-	for (auto& InstOf : BurnBoxInstsOf) {
-		AActor* BoxOwner = InstOf.Key;
-		const TArray<FIntVector>& BurningBoxIndices = InstOf.Value.Indices;
-		
-		for (FIntVector BurningBoxIndex : BurningBoxIndices) {
-			TArray<FIntVector> AggregateIndices;
-			TArray<FVector> AggregateHits;
-
-			FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[BurningBoxIndex].InstInfoOf[BoxOwner];
+	if (FirePresentation != FirePresentationMode::Instanced || !FireInstances) {
+		return;
+	}
 
-			// 각 연소 오브젝트의 현재 화염 확산 범위 깊이 우선 탐색(DFS)
-			if (HeatBoxInfo.Visited != true) {
-				AggregateIndices.Add(BurningBoxIndex);
-				AggregateHits.Append(HeatBoxInfo.HitPoints);
-				
-				FVector BoxWorldPos;
-				GetMapWorldPos(BurningBoxIndex, BoxWorldPos);
-				AggregateHitPoints(BurningBoxIndex, BoxOwner, AggregateIndices, AggregateHits);
-				
-				// 현재 화염 범위 생성
-				NewGoingFires.Add(BoxOwner, MakeShared<FFireInBox
-				>(AggregateIndices));
+	FireInstances->BeginFires();
 
-				PointEstimator PtEstimator;
-#if WITH_EDITOR	
-				if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_Estimator) {
-					PointEstimator Temp_PtEstimator(AggregateHits, GetWorld(), BoxWorldPos.Z);
-					PtEstimator = Temp_PtEstimator;
-				}
-				
-				else {
-					PointEstimator Temp_PtEstimator(AggregateHits);
-					PtEstimator = Temp_PtEstimator;
-				}
-#else
-				PointEstimator Temp_PointEstimator(AggregateHits);
-				PtEstimator = Temp_PointEstimator;
-#endif
-				FVector2D EstimatedCenter = PtEstimator.EstimateCenter2D();
-				float EstimateCenterPosZ = PtEstimator.EstimateCenterPosZ();
-				float EstimatedArea = PtEstimator.EstimateArea2D();
-				
-				TArray<TSharedPtr<FFireInBox>*> OldFiresToCheck;
-				GoingFires.MultiFindPointer(BoxOwner, OldFiresToCheck);
-
-				// 현재 화염 확산 범위와 기존 화염 확산 범위를 비교 및 업데이트
-				//Note: Null Pointer 반환시 기존 화염 확산 범위와 동일
-				bool OldFireChecked = OldFiresToCheck.ContainsByPredicate([&](TSharedPtr<FFireInBox>*& FireToCheck){
-					return (*FireToCheck)->BoxIndices == AggregateIndices;
-					});
-				if(!OldFireChecked) {
-					TArray<TSharedPtr<FFireInBox>*> NewFiresToCheck;
-					NewGoingFires.MultiFindPointer(BoxOwner, NewFiresToCheck);
-
-					auto NewFireChecked = NewFiresToCheck.FindByPredicate([&](TSharedPtr<FFireInBox>*& FireToCheck) {
-						return (*FireToCheck)->BoxIndices == AggregateIndices;
-						});
-					check(NewFireChecked);
-					(**NewFireChecked)->SpawnLocation = FVector(EstimatedCenter, EstimateCenterPosZ);
-					
-					// 이펙트 최초 생성 
-					(**NewFireChecked)->SpawnSize = HeatBoxInfo.ClampFireSize(EstimatedArea);
+	for (const auto& GoingFire : GoingFires) {
+		const FFireInBox& Fire = *GoingFire.Value;
+		FireInstances->AddFire(Fire.SpawnLocation, Fire.SpawnSize * FVector(Fire.FireSize, Fire.FireSize, 1.f), Fire.Intensity);
+	}
 
-					(**NewFireChecked)->FireEffect = GetWorld()->SpawnActor<AFireBlob>(FireEffectClass, FTransform(FRotator(), (**NewFireChecked)->SpawnLocation, (**NewFireChecked)->SpawnSize));
-				}
+	FireInstances->FlushFires();
+}
 
-				// 연소로 인해 방출된 열에너지를 히트맵에 반영합니다.
-				for (auto AggregateIndex : AggregateIndices) {
-					const int CoreIdx = MapToCoreIndex(AggregateIndex);
-					float& CurrentHeat = HeatGenField[CoreIdx];
-					
-					FHeatBoxInfo& AggHeatBoxInfo = HeatBoxAt[AggregateIndex].InstInfoOf[BoxOwner];
-					AggHeatBoxInfo.RadiationArea = EstimatedArea;
-					AggHeatBoxInfo.IgnitionCore = FVector(EstimatedCenter, EstimateCenterPosZ);
-					
-					float RadiatedHeatEnergy = AggHeatBoxInfo.RadiateHeat();
-					CurrentHeat += RadiatedHeatEnergy;
-				}
-			}
-		}
-	}
-		 
-	for (auto GoingFire : GoingFires) {
-		TArray<TSharedPtr<FFireInBox>*> StayingFiresCheck;
-		NewGoingFires.MultiFindPointer(GoingFire.Key, StayingFiresCheck);
-		auto StayingFireChecked = StayingFiresCheck.FindByPredicate([&](TSharedPtr<FFireInBox>*& FireToCheck) {
-			return (*FireToCheck)->BoxIndices == GoingFire.Value->BoxIndices;
-			});
-		// 현재 화염 범위와 동일한 기존 화염 범위 데이터 보존
-		if (StayingFireChecked) {
-			(**StayingFireChecked) = GoingFire.Value;
+void AHeatmap::EndFireAggregation()
+{
+	// 이번 집계에서 다시 찾지 못한 기존 화염 범위 소멸
+	for (auto GoingFire = GoingFires.CreateIterator(); GoingFire; ++GoingFire) {
+		if (GoingFire.Value()->Generation != FireGeneration) {
+			OrphanedFires.Add(GoingFire.Value());
+			GoingFire.RemoveCurrent();
 		}
-		// 현재 화염 범위와 동일하지 않은 기존 화염 범위 소멸
-		else  {
-			OrphanedFires.Add(GoingFire.Value);
-		} // StayingFireChecked == nullptr
 	}
 
 	if (OrphanedFires.Num() > 0) {
 		TArray<TSharedPtr<FFireInBox>> TempOrphanedFires = OrphanedFires;
 		for (auto TempOrphanedFire : TempOrphanedFires) {
-			
-			if(!TempOrphanedFire->FireEffect->GetIsPending()) {
+
+			// Instanced 모드의 화염은 다음 쓰기에서 빠집니다.
+			if (!TempOrphanedFire->FireEffect) {
+				OrphanedFires.Remove(TempOrphanedFire);
+			}
+
+			else if(!TempOrphanedFire->FireEffect->GetIsPending()) {
 				TempOrphanedFire->FireEffect->ShrinkToDeath();
 				
 			}
@@ -1117,19 +2251,10 @@ void AHeatmap::UpdateHeatmap()
 			}
 		}
 	}
+}
 
-	// 화염 범위 최신화
-	GoingFires = NewGoingFires;
-	
-	for (int i = 0; i < HeatGenField.Num(); i++) {
-		HeatGenField[i] += HeatGenField_Accumulator[i];
-	}
-
-	HeatGenField_Accumulator.Init(0., (NumDepthCells + 2)* (NumWidthCells + 2)* (NumHeightCells + 2));
-	
-	// 히트필드 업데이트
-	Diffuse(HeatGenField);
-
+void AHeatmap::UpdateHeatVisuals()
+{
 #if WITH_EDITOR
 	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatValue) {
 		TArray<UTextRenderComponent*> TextComponents;
@@ -1149,42 +2274,63 @@ void AHeatmap::UpdateHeatmap()
 					if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatValue) {
 						FString HeatStr = FString::Printf(TEXT("%.2f"), Heat);
 						TextComponents[InstIndex]->SetText(FText::FromString(HeatStr));
-					}
-				}
-			}
-		}
-	}
-	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
-		int InstIndex = -1;
-		for (int i = 0; i < NumDepthCells; i++) {
-			for (int j = 0; j < NumWidthCells; j++) {
-				for (int k = 0; k < NumHeightCells; k++) {
-					InstIndex++;
-					
-					FVector VizLoc(100.f * i, 100.f * j, 100.f * k);
-					FIntVector MapIdx;
-					GetMapIndex(VizLoc, MapIdx);
-					int CoreIdx = MapToCoreIndex(MapIdx);
-					float Heat = HeatGenField[CoreIdx];
-					
-					TArray<float> CustomData;
-					CustomData.Init(0.f, 4);
-					CustomData[0] = 1.f;
-					CustomData[1] = 0.f;
-					CustomData[2] = 0.f;
-					CustomData[3] = Heat;
-					GraphViz->SetCustomData(InstIndex, CustomData);
-					
+					}
 				}
 			}
 		}
 	}
-
 	if ((uint8)ShowHeatMap & (uint8)VisualVerbosity::Visual_HeatColor) {
-		GraphViz->MarkRenderStateDirty();
+		const int NumInstances = GraphViz->GetInstanceCount();
+		bool bDirty = false;
+
+		// Apply에서 만든 셀 인스턴스와 다르면 그리지 않습니다.
+		if (NumInstances != NumDepthCells * NumWidthCells * NumHeightCells || GraphViz->NumCustomDataFloats < 4) {
+			return;
+		}
+
+		// 인스턴스 순서(i, j, k)의 필드 인덱스는 한 번만 계산합니다. 첫 갱신에서 모든 인스턴스를 씁니다.
+		if (HeatVizCoreIdx.Num() != NumInstances) {
+			HeatVizCoreIdx.Reset(NumInstances);
+			for (int i = 0; i < NumDepthCells; i++) {
+				for (int j = 0; j < NumWidthCells; j++) {
+					for (int k = 0; k < NumHeightCells; k++) {
+						HeatVizCoreIdx.Add(MapToCoreIndex(FIntVector(i, j, k)));
+					}
+				}
+			}
+
+			HeatVizLevels.Init(MIN_int32, NumInstances);
+
+			// 색상 채널은 고정, 마지막 채널만 열
+			HeatVizCustomData.Init(0.f, GraphViz->NumCustomDataFloats);
+			HeatVizCustomData[0] = 1.f;
+		}
+
+		const float Quantization = FMath::Max(HeatVizQuantization, UE_KINDA_SMALL_NUMBER);
+
+		for (int InstIndex = 0; InstIndex < NumInstances; InstIndex++) {
+			const float Heat = HeatGenField[HeatVizCoreIdx[InstIndex]];
+			const int Level = FMath::RoundToInt(Heat / Quantization);
+			if (Level == HeatVizLevels[InstIndex]) {
+				continue;
+			}
+
+			HeatVizLevels[InstIndex] = Level;
+			HeatVizCustomData[3] = Heat;
+			GraphViz->SetCustomData(InstIndex, HeatVizCustomData, false);
+			bDirty = true;
+		}
+
+		// 바뀐 인스턴스가 있을 때만 렌더 상태를 한 번 갱신합니다.
+		if (bDirty) {
+			GraphViz->MarkRenderStateDirty();
+		}
 	}
 #endif
+}
 
+void AHeatmap::ApplyHeatDamage()
+{
 #if WITH_EDITOR
 	TEMPERATURE_LOG_HEADER()
 	MISC_LOG_HEADER()
@@ -1193,140 +2339,507 @@ void AHeatmap::UpdateHeatmap()
 
 	// FlammableActor 데미지 수용
 	for (auto& InstOf : FlamBoxInstsOf) {
-		AActor* BoxOwner = InstOf.Key;
-		const TArray<FIntVector>& FlammableBoxIndices = InstOf.Value.Indices;
-		for (FIntVector FlammableBoxIndex : FlammableBoxIndices) {
-			const int CoreIdx = MapToCoreIndex(FlammableBoxIndex);
-			float& CurrentHeat = HeatGenField[CoreIdx];
+		for (int Slot : InstOf.Value.Slots) {
+			ApplyHeatDamageAt(Slot);
+		}
+	}
+
+	// BurningActor 데미지 수용
+	for (auto& InstOf : BurnBoxInstsOf) {
+		for (int Slot : InstOf.Value.Slots) {
+			ApplyHeatDamageAt(Slot);
+		}
+	}
+}
 
-			FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[FlammableBoxIndex].InstInfoOf[BoxOwner];
+void AHeatmap::ApplyHeatDamageAt(int Slot)
+{
+	if (!CellStore.IsValidSlot(Slot)) {
+		return;
+	}
 
-			HeatBoxInfo.ReceiveHeat(CurrentHeat, UpdateInterval);
+	CellStore.ReceiveHeat(Slot, HeatGenField[CellStore.CoreIdx[Slot]], UpdateInterval);
 
 #if WITH_EDITOR
-			TEMPERATURE_LOG_BODY(FlammableBoxIndex)
-			MISC_LOG_BODY(FlammableBoxIndex)
-			HEATDMG_LOG_BODY(FlammableBoxIndex)
+	TEMPERATURE_LOG_BODY(Slot)
+	MISC_LOG_BODY(Slot)
+	HEATDMG_LOG_BODY(Slot)
 #endif
+}
+
+void AHeatmap::AccumulateHeat(TArray<float>& Field, TArray<float>& Accumulator) const
+{
+	for (int i = 0; i < Field.Num(); i++) {
+		Field[i] += Accumulator[i];
+	}
+
+	Accumulator.Init(0., Field.Num());
+}
+
+void AHeatmap::FlushHeatInputs()
+{
+	for (const FIntVector& HeatInputIndex : PendingHeatInputs) {
+		Solver.MarkCellActive(HeatInputIndex.X, HeatInputIndex.Y, HeatInputIndex.Z);
+	}
+
+	PendingHeatInputs.Reset();
+}
+
+void AHeatmap::ApplyDiffuseStats(const FHeatDiffuseStats& DiffuseStats)
+{
+	LastDiffuseIterations = DiffuseStats.Iterations;
+	LastDiffuseResidual = DiffuseStats.Residual;
+	NumActiveBricks = DiffuseStats.NumActiveBricks;
+}
+
+void AHeatmap::LaunchHeatSimTask()
+{
+	check(!HeatSimTask.IsValid());
+
+	// 백 버퍼에 히트필드와 셀 상태를 복사합니다.
+	SimBuffer.Field = HeatGenField;
+	SimBuffer.Accumulator = HeatGenField_Accumulator;
+	HeatGenField_Accumulator.Init(0., SimBuffer.Accumulator.Num());
+
+	FlushHeatInputs();
+
+	TArray<int> RegisteredSlots;
+	GatherRegisteredBoxes(RegisteredSlots);
+
+	SimBuffer.Cells.Reset(RegisteredSlots.Num());
+	for (int Slot : RegisteredSlots) {
+		SimBuffer.Cells.Emplace(Slot, CellStore.OwnerHandle[Slot], CellStore.CoreIdx[Slot], CellStore.GetMaterial(Slot).HeatAbsorbRate);
+	}
+
+	// 블루프린트에서 바꿀 수 있는 속성은 태스크가 읽지 않도록 여기서 복사합니다.
+	SimBuffer.DiffuseSettings = GetDiffuseSettings();
+	SimBuffer.UpdateInterval = UpdateInterval;
+
+	// 수치 연산(열 누적, 확산, 열 수용)은 백그라운드에서 수행합니다.
+	// 태스크가 끝날 때까지 Solver와 SimBuffer는 태스크가 소유합니다.
+	HeatSimTask = Async(EAsyncExecution::ThreadPool, [this]() {
+		AccumulateHeat(SimBuffer.Field, SimBuffer.Accumulator);
+
+		Diffuse(SimBuffer.Field, SimBuffer.DiffuseSettings, SimBuffer.DiffuseStats);
+
+		for (FHeatCellSnapshot& Cell : SimBuffer.Cells) {
+			Cell.HeatDamageReceived = FHeatCellStore::ComputeReceivedHeat(SimBuffer.Field[Cell.CoreIdx], SimBuffer.UpdateInterval, Cell.HeatAbsorbRate);
 		}
+	});
+}
+
+void AHeatmap::CompleteHeatSimTask()
+{
+	if (!HeatSimTask.IsValid()) {
+		return;
+	}
+
+	HeatSimTask.Wait();
+	HeatSimTask = TFuture<void>();
+
+	// 프론트 버퍼와 교체
+	Swap(HeatGenField, SimBuffer.Field);
+	ApplyDiffuseStats(SimBuffer.DiffuseStats);
+
+	UpdateHeatVisuals();
+
+#if WITH_EDITOR
+	TEMPERATURE_LOG_HEADER()
+	MISC_LOG_HEADER()
+	HEATDMG_LOG_HEADER()
+#endif
+
+	for (const FHeatCellSnapshot& Cell : SimBuffer.Cells) {
+		// 태스크 도중 등록 해제된 셀
+		if (!CellStore.IsValidSlot(Cell.Slot) || CellStore.OwnerHandle[Cell.Slot] != Cell.OwnerHandle) {
+			continue;
+		}
+
+		CellStore.ApplyReceivedHeat(Cell.Slot, Cell.HeatDamageReceived);
+
+#if WITH_EDITOR
+		TEMPERATURE_LOG_BODY(Cell.Slot)
+		MISC_LOG_BODY(Cell.Slot)
+		HEATDMG_LOG_BODY(Cell.Slot)
+#endif
+	}
+
+	PostUpdateHeatmap();
+}
+
+void AHeatmap::GatherRegisteredBoxes(TArray<int>& OutSlots) const
+{
+	OutSlots.Reset();
+	for (auto& InstOf : FlamBoxInstsOf) {
+		OutSlots.Append(InstOf.Value.Slots);
 	}
 
-	// BurningActor 데미지 수용
 	for (auto& InstOf : BurnBoxInstsOf) {
-		AActor* BoxOwner = InstOf.Key;
-		const TArray<FIntVector>& BurningBoxIndices = InstOf.Value.Indices;
-		for (FIntVector BurningBoxIndex : BurningBoxIndices) {
-			const int CoreIdx = MapToCoreIndex(BurningBoxIndex);
-			float& CurrentHeat = HeatGenField[CoreIdx];
-			
-			FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[BurningBoxIndex].InstInfoOf[BoxOwner];
+		OutSlots.Append(InstOf.Value.Slots);
+	}
+}
+
+void AHeatmap::BeginPipelineStep()
+{
+	if (PipelineStage != SimPipelineStage::Idle) {
+		// 이전 스텝이 예산 내에 끝나지 않았습니다. 이번 업데이트는 건너뜁니다.
+		UE_LOG(Firebox, Verbose, TEXT("Time-sliced step is still running (stage %d), skipping update"), (uint8)PipelineStage);
+		return;
+	}
+
+	EnterPipelineStage(SimPipelineStage::Transition);
+}
+
+void AHeatmap::AdvancePipeline()
+{
+	const double Deadline = FPlatformTime::Seconds() + TimeSliceBudgetMs / 1000.;
+
+	// 프레임마다 최소 한 단위는 진행합니다.
+	do {
+		RunPipelineUnit();
+	} while (PipelineStage != SimPipelineStage::Idle && FPlatformTime::Seconds() < Deadline);
+}
+
+void AHeatmap::EnterPipelineStage(SimPipelineStage NextStage)
+{
+	PipelineStage = NextStage;
+	SliceCursor = 0;
+
+	switch (NextStage)
+	{
+	case SimPipelineStage::Trace:
+		GatherBurningBoxes(SliceSlots);
+		BeginHitQueryPass(SliceSlots);
+		CaptureSliceSlotGenerations();
+		break;
+
+	case SimPipelineStage::Fire:
+		BeginFireAggregation();
+		BurnBoxInstsOf.GenerateKeyArray(SliceOwners);
+		break;
 
-			HeatBoxInfo.ReceiveHeat(CurrentHeat, UpdateInterval);
+	case SimPipelineStage::Diffuse:
+		AccumulateHeat(HeatGenField, HeatGenField_Accumulator);
+		FlushHeatInputs();
+
+		SliceDiffuseSettings = GetDiffuseSettings();
+		if (!BeginDiffuse(HeatGenField, SliceField, SliceDiffuseSettings, SliceDiffuseStats)) {
+			ApplyDiffuseStats(SliceDiffuseStats);
+			EnterPipelineStage(SimPipelineStage::Damage);
+		}
+		break;
+
+	case SimPipelineStage::Damage:
+		UpdateHeatVisuals();
 
 #if WITH_EDITOR
-			TEMPERATURE_LOG_BODY(BurningBoxIndex)
-			MISC_LOG_BODY(BurningBoxIndex)
-			HEATDMG_LOG_BODY(BurningBoxIndex)
+		TEMPERATURE_LOG_HEADER()
+		MISC_LOG_HEADER()
+		HEATDMG_LOG_HEADER()
 #endif
+
+		GatherRegisteredBoxes(SliceSlots);
+		CaptureSliceSlotGenerations();
+		break;
+
+	case SimPipelineStage::Post:
+		BurnBoxInstsOf.GenerateKeyArray(SliceOwners);
+		break;
+
+	case SimPipelineStage::Idle:
+		SliceSlots.Reset();
+		SliceSlotGenerations.Reset();
+		SliceOwners.Reset();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void AHeatmap::RunPipelineUnit()
+{
+	switch (PipelineStage)
+	{
+	case SimPipelineStage::Transition:
+		UpdatePhaseTransitions();
+		EnterPipelineStage(SimPipelineStage::Trace);
+		break;
+
+	case SimPipelineStage::Trace:
+		if (SliceCursor < SliceSlots.Num()) {
+			if (IsSliceSlotCurrent(SliceCursor)) {
+				TraceBurningBox(SliceSlots[SliceCursor]);
+			}
+			SliceCursor++;
+		}
+		else {
+			EndHitQueryPass(SliceSlots);
+			EnterPipelineStage(SimPipelineStage::Fire);
+		}
+		break;
+
+	case SimPipelineStage::Fire:
+		if (SliceCursor < SliceOwners.Num()) {
+			AggregateFiresOf(SliceOwners[SliceCursor]);
+			SliceCursor++;
+		}
+		else {
+			EndFireAggregation();
+			EnterPipelineStage(SimPipelineStage::Diffuse);
+		}
+		break;
+
+	case SimPipelineStage::Diffuse:
+		// 스윕(또는 V-cycle) 한 번 단위
+		if (StepDiffuse(HeatGenField, SliceField, SliceDiffuseSettings, SliceDiffuseStats)) {
+			EndDiffuse(HeatGenField, SliceField, SliceDiffuseSettings, SliceDiffuseStats);
+			ApplyDiffuseStats(SliceDiffuseStats);
+			EnterPipelineStage(SimPipelineStage::Damage);
+		}
+		break;
+
+	case SimPipelineStage::Damage:
+		if (SliceCursor < SliceSlots.Num()) {
+			if (IsSliceSlotCurrent(SliceCursor)) {
+				ApplyHeatDamageAt(SliceSlots[SliceCursor]);
+			}
+			SliceCursor++;
+		}
+		else {
+			EnterPipelineStage(SimPipelineStage::Post);
+		}
+		break;
+
+	case SimPipelineStage::Post:
+		if (SliceCursor < SliceOwners.Num()) {
+			PostUpdateBoxOwner(SliceOwners[SliceCursor]);
+			SliceCursor++;
 		}
+		else {
+			ApplyFireSizes();
+			UpdateFireEffectLOD();
+			FlushFireInstances();
+			EnterPipelineStage(SimPipelineStage::Idle);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void AHeatmap::CaptureSliceSlotGenerations()
+{
+	SliceSlotGenerations.Reset(SliceSlots.Num());
+	for (int Slot : SliceSlots) {
+		SliceSlotGenerations.Add(CellStore.SlotGeneration[Slot]);
 	}
 }
 
+bool AHeatmap::IsSliceSlotCurrent(int Index) const
+{
+	// 이전 프레임에 모은 슬롯은 그 사이 OnBoxOwnerDestroyed 등으로 비워지고 새 셀에 재사용되었을 수 있습니다.
+	const int Slot = SliceSlots[Index];
+	return CellStore.IsValidSlot(Slot) && CellStore.SlotGeneration[Slot] == SliceSlotGenerations[Index];
+}
+
 void AHeatmap::PostUpdateHeatmap()
 {
 	// FlammableActor 포스트-프로세싱
 	//for (auto & InstOf : FlamBoxInstsOf) {
 	//	AActor* BoxOwner = InstOf.Key;
-	//	const TArray<FIntVector>& FlammableBoxIndices = InstOf.Value.Indices;
-	//	for (FIntVector FlammableBoxIndex : FlammableBoxIndices) {
-	//		const int CoreIdx = MapToCoreIndex(FlammableBoxIndex);
-	//		float& CurrentHeat = HeatGenField[CoreIdx];
-
-	//		FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[FlammableBoxIndex].InstInfoOf[BoxOwner];
+	//	const TArray<int>& FlammableSlots = InstOf.Value.Slots;
+	//	for (int Slot : FlammableSlots) {
+	//		float& CurrentHeat = HeatGenField[CellStore.CoreIdx[Slot]];
 	//	}
 	//}
 
 	// BurningActor 포스트-프로세싱
 	for (auto& InstOf : BurnBoxInstsOf) {
-		AActor* BoxOwner = InstOf.Key;
-		const TArray<FIntVector>& BurningBoxIndices = InstOf.Value.Indices;
-		for (FIntVector BurningBoxIndex : BurningBoxIndices) {
-			// 초기화
-			const int CoreIdx = MapToCoreIndex(BurningBoxIndex);
-			float& CurrentHeat = HeatGenField[CoreIdx];
-			
-			FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[BurningBoxIndex].InstInfoOf[BoxOwner];
-			
-			HeatBoxInfo.Visited = false;
-			HeatBoxInfo.FuelCount--;
-			
-			CurrentHeat = 0.;
+		PostUpdateBoxOwner(InstOf.Key);
+	}
+
+	ApplyFireSizes();
+	UpdateFireEffectLOD();
+	FlushFireInstances();
+}
+
+void AHeatmap::PostUpdateBoxOwner(AActor* BoxOwner)
+{
+	const FBurningBoxInsts* BurningBoxInsts = BurnBoxInstsOf.Find(BoxOwner);
+	if (!BurningBoxInsts) {
+		return;
+	}
+
+	const TArray<int>& BurningSlots = BurningBoxInsts->Slots;
+	for (int Slot : BurningSlots) {
+		// 초기화
+		float& CurrentHeat = HeatGenField[CellStore.CoreIdx[Slot]];
+		
+		CellStore.FuelCount[Slot]--;
+		
+		CurrentHeat = 0.;
+	}
+
+	for (uint64 FireSignature : BurningBoxInsts->FireSignatures) {
+		const TSharedPtr<FFireInBox>* GoingFire = GoingFires.Find(FireSignature);
+		if (!GoingFire) {
+			continue;
 		}
 
-		TArray<TSharedPtr<FFireInBox>> Fires;
-		GoingFires.MultiFind(BoxOwner, Fires);
+		const TSharedPtr<FFireInBox>& Fire = *GoingFire;
+
+		// 평균 영역 온도 구하기
+		const TArray<int>& FireDomain = Fire->BoxSlots;
+		int NumSubdomain = FireDomain.Num();
+		check(NumSubdomain);
+		float AggregateTemp = 0;
+		float AverageTemp = 0;
+		for (int FireSubdomain : FireDomain) {
+			AggregateTemp += CellStore.CurrTemperature[FireSubdomain];
 		
-		for (auto Fire : Fires) {
-			// 평균 영역 온도 구하기
-			TArray<FIntVector> FireDomain = Fire->BoxIndices;
-			int NumSubdomain = FireDomain.Num();
-			check(NumSubdomain);
-			float AggregateTemp = 0;
-			float AverageTemp = 0;
-			for (auto FireSubdomain : FireDomain) {
-				AggregateTemp += HeatBoxAt[FireSubdomain].InstInfoOf[BoxOwner].CurrTemperature;
-			
-				if (FireSubdomain == FireDomain.Last()) {
-					AverageTemp = AggregateTemp / NumSubdomain;
+			if (FireSubdomain == FireDomain.Last()) {
+				AverageTemp = AggregateTemp / NumSubdomain;
 
-					float TempA = HeatBoxAt[FireSubdomain].InstInfoOf[BoxOwner].IgnitionPoint;
-					float TempB = HeatBoxAt[FireSubdomain].InstInfoOf[BoxOwner].MaxTemperature;
-					float SizeA = Fire->SpawnSize[0];
-					float SizeB = HeatBoxAt[FireSubdomain].InstInfoOf[BoxOwner].MaxFireSize;
+				const FHeatBoxMaterial& Material = CellStore.GetMaterial(FireSubdomain);
+				float TempA = Material.IgnitionPoint;
+				float TempB = Material.MaxTemperature;
+				float SizeA = Fire->SpawnSize[0];
+				float SizeB = Material.MaxFireSize;
 
-					// 이펙트 크기에 반영하기
-					float NewFireSize = FMath::GetMappedRangeValueClamped(FVector2D(TempA, TempB), FVector2D(SizeA, SizeB), AverageTemp);
-					
-					Fire->SetFireSize(NewFireSize);
+				// 이펙트 크기에 반영하기
+				float NewFireSize = FMath::GetMappedRangeValueClamped(FVector2D(TempA, TempB), FVector2D(SizeA, SizeB), AverageTemp);
+				
+				// 크기 변경은 모아 두었다가 포스트 업데이트 끝에 한 번에 반영합니다.
+				if (FMath::Abs(NewFireSize - Fire->FireSize) > FireSizeUpdateThreshold) {
+					PendingFireSizes.Emplace(FireSignature, NewFireSize);
+				}
+
+				else {
+					PendingFireSizesSkipped++;
 				}
+
+				Fire->Intensity = FMath::GetMappedRangeValueClamped(FVector2D(TempA, TempB), FVector2D(0.f, 1.f), AverageTemp);
 			}
 		}
+	}
 
-		float BodyTemp = GetBodyTemperature(BoxOwner);
-		float MaxTemp;
-		GetHBParam(BoxOwner, SetHeatBoxFuncParamType::MaxTemperature, MaxTemp);
-		float BodyHalfFullTemp = MaxTemp / 2;
+	float BodyTemp = GetBodyTemperature(BoxOwner);
+	float MaxTemp;
+	GetHBParam(BoxOwner, SetHeatBoxFuncParamType::MaxTemperature, MaxTemp);
+	float BodyHalfFullTemp = MaxTemp / 2;
 
-		if (BodyTemp >= BodyHalfFullTemp) {
-			OnBodyHalfBurnt.Broadcast(BoxOwner);
-		}
-		
+	if (BodyTemp >= BodyHalfFullTemp) {
+		OnBodyHalfBurnt.Broadcast(BoxOwner);
+	}
+}
+
+void AHeatmap::Diffuse(TArray<float>& Field, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats)
+{
+	TArray<float> NewField;
+
+	if (!BeginDiffuse(Field, NewField, Settings, OutStats)) {
+		return;
+	}
 
+	while (!StepDiffuse(Field, NewField, Settings, OutStats)) {
+	}
+
+	EndDiffuse(Field, NewField, Settings, OutStats);
+}
+
+FHeatDiffuseSettings AHeatmap::GetDiffuseSettings() const
+{
+	FHeatDiffuseSettings Settings;
+	Settings.SolverType = SolverType;
+	Settings.bParallel = bParallelDiffuse;
+	Settings.bSparse = bSparseDiffusion && SolverType == DiffusionSolver::Relaxation;
+	Settings.NumSlabs = NumDiffuseSlabs;
+	Settings.Tolerance = DiffuseTolerance;
+	Settings.MinIterations = FMath::Max(1, MinDiffuseIterations);
+	Settings.MaxIterations = FMath::Max(Settings.MinIterations, MaxDiffuseIterations);
+	Settings.ActiveBrickThreshold = ActiveBrickThreshold;
+#if WITH_EDITOR
+	Settings.bValidateParallel = bValidateParallelDiffuse;
+	Settings.ValidationTolerance = DiffuseValidationTolerance;
+#endif
+
+	return Settings;
+}
+
+bool AHeatmap::BeginDiffuse(const TArray<float>& Field, TArray<float>& NewField, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats)
+{
+	OutStats = FHeatDiffuseStats();
+
+	// 활성 브릭이 없으면 확산할 열이 없습니다.
+	if (Settings.bSparse && Solver.BeginSparseSolve() == 0) {
+		return false;
+	}
+
+	NewField = Field;
+
+	// 열량 규모가 장면마다 크게 다르므로 필드 크기에 대한 상대 변화량으로 수렴을 판정합니다.
+	for (float Value : Field) {
+		OutStats.FieldScale = FMath::Max(OutStats.FieldScale, FMath::Abs(Value));
+	}
+
+	return true;
+}
+
+bool AHeatmap::StepDiffuse(const TArray<float>& Field, TArray<float>& NewField, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats)
+{
+	float Residual = 0.f;
 
+	if (Settings.bSparse) {
+		Residual = Solver.RelaxSparse(Field, NewField, Settings.bParallel);
+	}
+	else if (Settings.SolverType == DiffusionSolver::Multigrid && Multigrid.IsValid()) {
+		Residual = Multigrid.VCycle(Field, NewField, Settings.bParallel, Settings.NumSlabs);
+	}
+	else if (Settings.bParallel) {
+		Residual = Solver.RelaxParallel(Field, NewField, Settings.NumSlabs);
+	}
+	else {
+		Residual = Solver.RelaxSerial(Field, NewField);
 	}
+
+	OutStats.Iterations++;
+	OutStats.Residual = Residual;
+
+	// 수렴 판정
+	return OutStats.Iterations >= Settings.MaxIterations || (OutStats.Iterations >= Settings.MinIterations && Residual <= Settings.Tolerance * OutStats.FieldScale);
 }
 
-void AHeatmap::Diffuse(TArray<float>& Field)
+void AHeatmap::EndDiffuse(TArray<float>& Field, TArray<float>& NewField, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats)
 {
-	TArray<float> NewField = Field;
+	if (Settings.bSparse) {
+		Solver.EndSparseSolve(NewField, Settings.ActiveBrickThreshold);
+		OutStats.NumActiveBricks = Solver.GetNumActiveBricks();
+	}
 
-	for (int n = 0; n < 20; n++) {
-		for (int i = 1; i <= NumDepthCells; i++) {
-			for (int j = 1; j <= NumWidthCells; j++) {
-				for (int k = 1; k <= NumHeightCells; k++) {
-					NewField[CoreIndex(i, j, k)] = (
-						Field[CoreIndex(i, j, k)] +
-						HeatTransferRate * (
-							NewField[CoreIndex(i - 1, j, k)] + NewField[CoreIndex(i + 1, j, k)] +
-							NewField[CoreIndex(i, j - 1, k)] + NewField[CoreIndex(i, j + 1, k)] +
-							NewField[CoreIndex(i, j, k - 1)] + NewField[CoreIndex(i, j, k + 1)])
-						) / (1 + 6 * HeatTransferRate);
-				}
-			}
+#if WITH_EDITOR
+	if (Settings.SolverType == DiffusionSolver::Relaxation && !Settings.bSparse && Settings.bParallel && Settings.bValidateParallel) {
+		// 직렬 기준 결과와 비교
+		TArray<float> RefField = Field;
+		for (int RefIteration = 0; RefIteration < OutStats.Iterations; RefIteration++) {
+			Solver.RelaxSerial(Field, RefField);
+		}
+
+		float MaxError = 0.f;
+		float MaxHeat = 0.f;
+		for (int i = 0; i < RefField.Num(); i++) {
+			MaxError = FMath::Max(MaxError, FMath::Abs(RefField[i] - NewField[i]));
+			MaxHeat = FMath::Max(MaxHeat, FMath::Abs(RefField[i]));
+		}
+
+		if (MaxError > Settings.ValidationTolerance * FMath::Max(MaxHeat, 1.f)) {
+			UE_LOG(Firebox, Warning, TEXT("Parallel diffusion deviates from serial reference (max error %f, max heat %f)"), MaxError, MaxHeat);
 		}
 	}
+#endif
 
-	Field = NewField;
+	Field = MoveTemp(NewField);
 }
 
 bool AHeatmap::GetMapIndex(const FVector& RelPos, FIntVector& OutMapIndex) const
@@ -1460,27 +2973,43 @@ FVector AHeatmap::RandRangeFromBoxSurface(const FVector& Center, const FVector&
 }
 
 
-float AHeatmap::BoxDiagLenth(const FVector& Spacings)
+FVector AHeatmap::BoxFacePoint(const FVector& Center, const FVector& Spacings, BoxFaces Face, const FVector2D& UV)
 {
-	return FMath::Sqrt( FMath::Square(Spacings.X) + FMath::Square(Spacings.Y) + FMath::Square(Spacings.Z) );
+	FBoxVertices BoxVertices;
+	GetBoxVertices(Center, Spacings, BoxVertices);
+
+	const float X = FMath::Lerp(BoxVertices[0].X, BoxVertices[1].X, UV.X);
+	const float Y = FMath::Lerp(BoxVertices[0].Y, BoxVertices[2].Y, (Face == BoxFaces::Front || Face == BoxFaces::Back) ? UV.X : UV.Y);
+	const float Z = FMath::Lerp(BoxVertices[0].Z, BoxVertices[4].Z, UV.Y);
+
+	switch (Face)
+	{
+		case BoxFaces::Bottom:
+			return FVector(X, Y, BoxVertices[0].Z);
+		
+		case BoxFaces::Top:
+			return FVector(X, Y, BoxVertices[4].Z);
+		
+		case BoxFaces::Left:
+			return FVector(X, BoxVertices[0].Y, Z);
+
+		case BoxFaces::Right:
+			return FVector(X, BoxVertices[2].Y, Z);
+	
+		case BoxFaces::Front:
+			return FVector(BoxVertices[0].X, Y, Z);
+		
+		case BoxFaces::Back:
+			return FVector(BoxVertices[1].X, Y, Z);
+		
+		default:
+			check(0);
+			return Center;
+	}
 }
 
-void AHeatmap::AggregateHitPoints(const FIntVector& BaseIndex, const AActor* BoxOwner, TArray<FIntVector>& AggregatorIndices, TArray<FVector>& AggregatedHitPoints)
+float AHeatmap::BoxDiagLenth(const FVector& Spacings)
 {
-	HeatBoxAt[BaseIndex].InstInfoOf[BoxOwner].Visited = true;
-
-		for (int i = 0; i < 4; ++i) {
-			FIntVector Offset = { 0, 0, 0 };
-			Offset[i % 2] = 1 - 2 * (i / 2);
-			FIntVector IndexToSearch = BaseIndex + Offset;
-			if (BurnBoxInstsOf[BoxOwner].Indices.Contains(IndexToSearch)) {
-				FHeatBoxInfo& HeatBoxInfo = HeatBoxAt[IndexToSearch].InstInfoOf[BoxOwner];
-				if (!HeatBoxInfo.Visited) {
-					AggregatedHitPoints.Append(HeatBoxInfo.HitPoints);
-					AggregatorIndices.Add(IndexToSearch);
-					AggregateHitPoints(IndexToSearch, BoxOwner, AggregatorIndices, AggregatedHitPoints);
-				}
-			}
-		}
+	return FMath::Sqrt( FMath::Square(Spacings.X) + FMath::Square(Spacings.Y) + FMath::Square(Spacings.Z) );
 }
 
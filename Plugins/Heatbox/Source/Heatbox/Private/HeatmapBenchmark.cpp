@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Heatmap.h"
+#include "Heatbox.h"
+#include "HeatSolver.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+void AHeatmap::BenchmarkDiffusion()
+{
+	const int GridSizes[] = { 32, 64, 128 };
+	FRandomStream RandomStream(1234);
+
+	for (int N : GridSizes) {
+		HeatSolver BenchSolver(N, N, N, HeatTransferRate);
+		HeatMultigrid BenchMultigrid(N, N, N, HeatTransferRate);
+
+		// 임의의 열원 배치
+		TArray<float> Source;
+		Source.Init(0.f, BenchSolver.GetFieldSize());
+		for (int n = 0; n < N; n++) {
+			const int i = RandomStream.RandRange(1, N);
+			const int j = RandomStream.RandRange(1, N);
+			const int k = RandomStream.RandRange(1, N);
+			Source[BenchSolver.CoreIndex(i, j, k)] = RandomStream.FRandRange(10.f, 1000.f);
+		}
+
+		TArray<float> Residual;
+
+		// 기존 방식: 20회 직렬 이완
+		TArray<float> Field = Source;
+		double StartTime = FPlatformTime::Seconds();
+		for (int n = 0; n < 20; n++) {
+			BenchSolver.RelaxSerial(Source, Field);
+		}
+		const double LegacyMs = (FPlatformTime::Seconds() - StartTime) * 1000.;
+		const float LegacyResidual = BenchSolver.ComputeResidual(Source, Field, Residual);
+
+		// 20회 병렬 이완
+		Field = Source;
+		StartTime = FPlatformTime::Seconds();
+		for (int n = 0; n < 20; n++) {
+			BenchSolver.RelaxParallel(Source, Field, NumDiffuseSlabs);
+		}
+		const double ParallelMs = (FPlatformTime::Seconds() - StartTime) * 1000.;
+		const float ParallelResidual = BenchSolver.ComputeResidual(Source, Field, Residual);
+
+		// 멀티그리드: 허용 오차까지 V-cycle
+		float SourceScale = 0.f;
+		for (float Value : Source) {
+			SourceScale = FMath::Max(SourceScale, FMath::Abs(Value));
+		}
+
+		Field = Source;
+		int NumCycles = 0;
+		StartTime = FPlatformTime::Seconds();
+		while (NumCycles < FMath::Max(1, MaxDiffuseIterations)) {
+			NumCycles++;
+			if (BenchMultigrid.VCycle(Source, Field, bParallelDiffuse, NumDiffuseSlabs) <= DiffuseTolerance * SourceScale) {
+				break;
+			}
+		}
+		const double MultigridMs = (FPlatformTime::Seconds() - StartTime) * 1000.;
+		const float MultigridResidual = BenchSolver.ComputeResidual(Source, Field, Residual);
+
+		UE_LOG(Firebox, Log, TEXT("[Diffusion %d^3] Relaxation x20: %.2f ms (residual %g) | Parallel x20: %.2f ms (residual %g) | Multigrid x%d (%d levels): %.2f ms (residual %g)"),
+			N, LegacyMs, LegacyResidual, ParallelMs, ParallelResidual, NumCycles, BenchMultigrid.GetNumLevels(), MultigridMs, MultigridResidual);
+	}
+}
+
+void AHeatmap::BenchmarkPhaseTransitions()
+{
+	const int NumCellsList[] = { 1024, 4096, 16384 };
+	const int NumOwners = 64;
+	const int NumTicks = 20;
+	FRandomStream RandomStream(1234);
+
+	for (int NumCells : NumCellsList) {
+		// 소유자별 가연/연소 레지스트리 (슬롯 = 셀 인덱스)
+		TMap<int, TArray<int>> InitialFlammable;
+		for (int Slot = 0; Slot < NumCells; Slot++) {
+			InitialFlammable.FindOrAdd(Slot % NumOwners).Add(Slot);
+		}
+
+		// 틱마다 약 5%의 셀이 위상을 바꿉니다.
+		TArray<TArray<bool>> TransitionsPerTick;
+		for (int Tick = 0; Tick < NumTicks; Tick++) {
+			TArray<bool>& Transitions = TransitionsPerTick.AddDefaulted_GetRef();
+			Transitions.Init(false, NumCells);
+			for (int Slot = 0; Slot < NumCells; Slot++) {
+				Transitions[Slot] = RandomStream.FRand() < 0.05f;
+			}
+		}
+
+		// 기존 방식: 레지스트리 복사 후 TArray::Remove
+		TMap<int, TArray<int>> FlammableOf = InitialFlammable;
+		TMap<int, TArray<int>> BurningOf;
+		double StartTime = FPlatformTime::Seconds();
+		for (int Tick = 0; Tick < NumTicks; Tick++) {
+			const TArray<bool>& Transitions = TransitionsPerTick[Tick];
+
+			TMap<int, TArray<int>> Temp_FlammableOf = FlammableOf;
+			TMap<int, TArray<int>> Temp_BurningOf = BurningOf;
+			for (auto& InstOf : Temp_FlammableOf) {
+				for (int Slot : InstOf.Value) {
+					if (Transitions[Slot]) {
+						BurningOf.FindOrAdd(InstOf.Key).Add(Slot);
+						FlammableOf[InstOf.Key].Remove(Slot);
+					}
+				}
+			}
+
+			for (auto& InstOf : Temp_BurningOf) {
+				for (int Slot : InstOf.Value) {
+					if (Transitions[Slot]) {
+						FlammableOf.FindOrAdd(InstOf.Key).Add(Slot);
+						BurningOf[InstOf.Key].Remove(Slot);
+					}
+				}
+			}
+		}
+		const double LegacyMs = (FPlatformTime::Seconds() - StartTime) * 1000. / NumTicks;
+
+		// 위상 변화 큐 + 압축
+		FlammableOf = InitialFlammable;
+		BurningOf.Reset();
+		TArray<HeatCellPhase> Phases;
+		Phases.Init(HeatCellPhase::Flammable, NumCells);
+		TArray<FHeatCellTransition> Queue;
+		TSet<int> TransitionOwners;
+		StartTime = FPlatformTime::Seconds();
+		for (int Tick = 0; Tick < NumTicks; Tick++) {
+			const TArray<bool>& Transitions = TransitionsPerTick[Tick];
+
+			Queue.Reset();
+			for (auto& InstOf : FlammableOf) {
+				for (int Slot : InstOf.Value) {
+					if (Transitions[Slot]) {
+						Queue.Emplace(Slot, HeatCellPhase::Burning);
+					}
+				}
+			}
+
+			for (auto& InstOf : BurningOf) {
+				for (int Slot : InstOf.Value) {
+					if (Transitions[Slot]) {
+						Queue.Emplace(Slot, HeatCellPhase::Flammable);
+					}
+				}
+			}
+
+			TransitionOwners.Reset();
+			for (const FHeatCellTransition& Transition : Queue) {
+				const int Owner = Transition.Slot % NumOwners;
+				TArray<int>& Registry = (Transition.NewPhase == HeatCellPhase::Burning) ? BurningOf.FindOrAdd(Owner) : FlammableOf.FindOrAdd(Owner);
+				Registry.Add(Transition.Slot);
+				Phases[Transition.Slot] = Transition.NewPhase;
+				TransitionOwners.Add(Owner);
+			}
+
+			for (int Owner : TransitionOwners) {
+				FlammableOf[Owner].RemoveAll([&](int Slot) { return Phases[Slot] != HeatCellPhase::Flammable; });
+				BurningOf[Owner].RemoveAll([&](int Slot) { return Phases[Slot] != HeatCellPhase::Burning; });
+			}
+		}
+		const double QueueMs = (FPlatformTime::Seconds() - StartTime) * 1000. / NumTicks;
+
+		UE_LOG(Firebox, Log, TEXT("[Phase transitions %d cells] Copy + Remove: %.3f ms/tick | Queue + compaction: %.3f ms/tick"),
+			NumCells, LegacyMs, QueueMs);
+	}
+}
+
+void AHeatmap::BenchmarkHitQueries()
+{
+	TArray<int> Slots;
+	GatherRegisteredBoxes(Slots);
+	if (Slots.Num() == 0 || !GetWorld()) {
+		UE_LOG(Firebox, Warning, TEXT("Register actors before running the hit query benchmark"));
+		return;
+	}
+
+	const int NumTraces = 20000;
+
+	// 등록된 모든 액터를 연소 중인 것으로 보고 무시 목록을 만듭니다.
+	TArray<AActor*> BurningActors = CellStore.Owners;
+
+	FCollisionObjectQueryParams CollObjQueryParams;
+	CollObjQueryParams.AddObjectTypesToQuery(ECC_GameTraceChannel1);
+
+	TArray<FVector> TraceStarts;
+	TArray<FVector> TraceEnds;
+	TraceStarts.SetNumUninitialized(NumTraces);
+	TraceEnds.SetNumUninitialized(NumTraces);
+	for (int n = 0; n < NumTraces; n++) {
+		GetHitQuerySegment(Slots[n % Slots.Num()], n, TraceStarts[n], TraceEnds[n]);
+	}
+
+	// 기존 방식: 레이마다 무시 목록과 쿼리 파라미터 생성
+	int LegacyHits = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int n = 0; n < NumTraces; n++) {
+		AActor* BoxOwner = CellStore.GetBoxOwner(Slots[n % Slots.Num()]);
+
+		TArray<AActor*> IgnoredActors = BurningActors;
+		IgnoredActors.Remove(BoxOwner);
+
+		FCollisionQueryParams CollQueryParams;
+		CollQueryParams.AddIgnoredActors(IgnoredActors);
+
+		FHitResult HitResult;
+		LegacyHits += GetWorld()->LineTraceSingleByObjectType(HitResult, TraceStarts[n], TraceEnds[n], CollObjQueryParams, CollQueryParams) ? 1 : 0;
+	}
+	const double LegacySeconds = FPlatformTime::Seconds() - StartTime;
+
+	// 소유자별 캐시
+	int CachedHits = 0;
+	TMap<const AActor*, FCollisionQueryParams> ParamsOf;
+	StartTime = FPlatformTime::Seconds();
+	for (int n = 0; n < NumTraces; n++) {
+		const AActor* BoxOwner = CellStore.GetBoxOwner(Slots[n % Slots.Num()]);
+
+		FCollisionQueryParams* CollQueryParams = ParamsOf.Find(BoxOwner);
+		if (!CollQueryParams) {
+			CollQueryParams = &ParamsOf.Add(BoxOwner);
+			for (const AActor* BurningActor : BurningActors) {
+				if (BurningActor != BoxOwner) {
+					CollQueryParams->AddIgnoredActor(BurningActor);
+				}
+			}
+		}
+
+		FHitResult HitResult;
+		CachedHits += GetWorld()->LineTraceSingleByObjectType(HitResult, TraceStarts[n], TraceEnds[n], CollObjQueryParams, *CollQueryParams) ? 1 : 0;
+	}
+	const double CachedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(Firebox, Log, TEXT("[Hit queries %d traces, %d actors] Per-ray params: %.0f traces/s (%d hits) | Cached params: %.0f traces/s (%d hits)"),
+		NumTraces, BurningActors.Num(), NumTraces / FMath::Max(LegacySeconds, 1e-9), LegacyHits, NumTraces / FMath::Max(CachedSeconds, 1e-9), CachedHits);
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitQuerySampler.h"
+
+FVector2D HitQuerySampler::Sobol2D(uint32 Index, uint32 Scramble)
+{
+	// 첫 번째 차원은 2진 역순 수, 두 번째 차원은 원시 다항식 x + 1의 방향 수
+	uint32 Dim0 = ReverseBits(Index);
+	uint32 Dim1 = 0;
+	for (uint32 Direction = 1u << 31; Index; Index >>= 1, Direction ^= Direction >> 1) {
+		if (Index & 1) {
+			Dim1 ^= Direction;
+		}
+	}
+
+	Dim0 ^= Scramble;
+	Dim1 ^= (Scramble * 0x9E3779B9u);
+
+	return FVector2D(Dim0 * (1.0 / 4294967296.0), Dim1 * (1.0 / 4294967296.0));
+}
+
+float HitQuerySampler::RadicalInverse3(uint32 Index, float Shift)
+{
+	double Result = 0.;
+	double InvBase = 1. / 3.;
+	for (double Digit = InvBase; Index; Index /= 3, Digit *= InvBase) {
+		Result += (Index % 3) * Digit;
+	}
+
+	Result += Shift;
+	return (float)(Result - FMath::FloorToDouble(Result));
+}
+
+int HitQuerySampler::PickFace(const float* FaceWeights, float U)
+{
+	float TotalWeight = 0.f;
+	for (int Face = 0; Face < NumFaces; Face++) {
+		TotalWeight += FaceWeights[Face];
+	}
+
+	float Threshold = U * TotalWeight;
+	for (int Face = 0; Face < NumFaces - 1; Face++) {
+		if (Threshold < FaceWeights[Face]) {
+			return Face;
+		}
+		Threshold -= FaceWeights[Face];
+	}
+
+	return NumFaces - 1;
+}
+
+uint32 HitQuerySampler::CellScramble(const FIntVector& MapIndex)
+{
+	uint32 Hash = (uint32)MapIndex.X * 73856093u ^ (uint32)MapIndex.Y * 19349663u ^ (uint32)MapIndex.Z * 83492791u;
+	Hash ^= Hash >> 16;
+	Hash *= 0x7FEB352Du;
+	Hash ^= Hash >> 15;
+	return Hash;
+}
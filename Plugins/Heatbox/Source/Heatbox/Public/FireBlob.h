@@ -23,15 +23,15 @@ protected:
 
 
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	UFUNCTION(BlueprintImplementableEvent, Category="Fire Blob")
 	void ShrinkToDeath();
 	
 	UFUNCTION()
 	void PauseFireEffect();
 
+	UFUNCTION()
+	void ResumeFireEffect();
+
 	UFUNCTION()
 	float GetTimeToBurnOut() const;
 
@@ -47,6 +47,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Fire Blob")
 	uint8 GetMarkForDestroy();
 
+	/**
+	* Hide and stop the effect so the heatmap can reuse this actor.
+	**/
+	void ReturnToPool();
+
+	/**
+	* Move a pooled actor into place and restart the effect at its initial size.
+	**/
+	void ReuseFromPool(const FTransform& SpawnTransform);
+
 
 
 private:
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NiagaraComponent.h"
+#include "FireInstanceComponent.generated.h"
+
+/**
+* 모든 화염 범위를 하나의 나이아가라 시스템으로 그립니다.
+* 시스템은 월드 공간 배열 사용자 파라미터(위치, 크기, 세기)를 읽어 화염 범위마다 이미터 인스턴스를 만들어야 합니다.
+**/
+UCLASS(ClassGroup = (Heatbox), meta = (BlueprintSpawnableComponent))
+class HEATBOX_API UFireInstanceComponent : public UNiagaraComponent
+{
+	GENERATED_BODY()
+
+public:
+	UFireInstanceComponent();
+
+	/**
+	* 이번 스텝의 화염 목록을 비웁니다.
+	**/
+	void BeginFires();
+
+	/**
+	**/
+	void AddFire(const FVector& Position, const FVector& Size, float Intensity);
+
+	/**
+	* 모은 화염을 배열 데이터 인터페이스에 한 번에 씁니다.
+	**/
+	void FlushFires();
+
+	FORCEINLINE int GetNumFires() const
+	{
+		return Positions.Num();
+	}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Instances")
+	FName PositionsParameter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Instances")
+	FName SizesParameter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Instances")
+	FName IntensitiesParameter;
+
+private:
+	TArray<FVector> Positions;
+	TArray<FVector> Sizes;
+	TArray<float> Intensities;
+};
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* 연소 셀의 화염 영역(X/Y 4-이웃 연결 요소)을 점유 격자 위에서 반복형 Union-Find로 라벨링합니다.
+* 셀 개수에 선형으로 동작하며 재귀나 방문 플래그를 사용하지 않습니다.
+**/
+class HEATBOX_API FireRegionLabeler
+{
+public:
+	FireRegionLabeler()
+	{}
+
+	/**
+	* 영역 개수를 반환합니다.
+	* 영역 번호는 각 영역의 첫 셀이 Cells에 나타나는 순서를 따르고, 영역 안의 셀은 Cells 순서를 유지합니다.
+	**/
+	int Label(const TArray<FIntVector>& Cells);
+
+	/**
+	**/
+	int GetNumRegions() const;
+
+	/**
+	* 영역에 속한 셀의 Cells 인덱스
+	**/
+	TConstArrayView<int> GetRegion(int Region) const;
+
+	/**
+	**/
+	int GetRegionOf(int CellIndex) const;
+
+	/**
+	* 영역 셀 해시의 합. 셀 순서와 무관하며 셀 집합이 같으면 같은 값을 가집니다.
+	**/
+	uint64 GetRegionSignature(int Region) const;
+
+	/**
+	* 64비트 비트 혼합 함수 (SplitMix64 최종 단계)
+	**/
+	static uint64 Mix(uint64 Value);
+
+	/**
+	**/
+	static uint64 HashCell(const FIntVector& Cell);
+
+private:
+	/**
+	**/
+	int FindRoot(int Element);
+
+	/**
+	* 번호가 작은 루트 쪽으로 합칩니다.
+	**/
+	void Union(int A, int B);
+
+private:
+	// 경계 상자 격자: 셀 인덱스 + 1 (0 = 비어 있음)
+	TArray<int> Occupancy;
+
+	TArray<int> Parent;
+
+	TArray<int> RegionOf;
+
+	// 영역별 RegionElements 시작 위치 (NumRegions + 1)
+	TArray<int> RegionStarts;
+
+	TArray<int> RegionElements;
+
+	TArray<uint64> RegionSignatures;
+};
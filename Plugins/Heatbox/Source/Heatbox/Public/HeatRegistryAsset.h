@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Heatmap.h"
+#include "HeatRegistryAsset.generated.h"
+
+/**
+* 구워진 등록 액터 하나. 셀은 UHeatRegistryAsset의 평면 배열 [CellStart, CellStart + CellCount) 구간입니다.
+**/
+USTRUCT()
+struct FBakedBoxOwner
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	TSoftObjectPtr<AActor> Actor;
+
+	// 에디터 빌드에서만 검증합니다.
+	UPROPERTY(VisibleAnywhere)
+	FGuid ActorGuid;
+
+	// 구운 뒤 액터가 움직였는지 확인합니다.
+	UPROPERTY(VisibleAnywhere)
+	FTransform ActorTransform;
+
+	UPROPERTY(VisibleAnywhere)
+	FHeatBoxMaterial Material;
+
+	UPROPERTY(VisibleAnywhere)
+	int CellStart = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	int CellCount = 0;
+};
+
+/**
+* 정적 레벨의 AHeatmap 등록 결과 (액터별 셀 목록, 셀 파라미터, 표면 샘플)
+* 셀 배열은 태그 없이 통째로 직렬화하여 BeginPlay에서 겹침 쿼리 없이 레지스트리를 복원합니다.
+**/
+UCLASS(BlueprintType)
+class HEATBOX_API UHeatRegistryAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Serialize(FArchive& Ar) override;
+
+	/**
+	**/
+	void Reset();
+
+	/**
+	* 구울 때와 같은 히트맵 배치와 격자 크기이고 셀 배열 길이가 맞는지 확인합니다.
+	**/
+	bool MatchesHeatmap(const FTransform& InHeatmapTransform, const FIntVector& InNumCells) const;
+
+	UPROPERTY(VisibleAnywhere, Category = "Heat Registry")
+	FTransform HeatmapTransform;
+
+	UPROPERTY(VisibleAnywhere, Category = "Heat Registry")
+	FIntVector NumCells = FIntVector::ZeroValue;
+
+	UPROPERTY(VisibleAnywhere, Category = "Heat Registry")
+	TArray<FBakedBoxOwner> BoxOwners;
+
+	// 구울 때 겹침 쿼리로 찾은 'Firebox' 액터 (셀이 없는 액터 포함)
+	UPROPERTY(VisibleAnywhere, Category = "Heat Registry")
+	TArray<TSoftObjectPtr<AActor>> FlammableActors;
+
+	// 셀별 배열 (BoxOwners 순서)
+	TArray<FIntVector> CellMapIndex;
+	TArray<float> CellOccupancy;
+
+	// 셀마다 SurfaceSamples의 [Start, Start + Count) 구간
+	TArray<int> CellSampleStart;
+	TArray<int> CellSampleCount;
+	TArray<FVector3f> SurfaceSamples;
+};
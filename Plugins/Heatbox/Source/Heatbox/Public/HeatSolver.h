@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* 패딩된 히트필드((NumDepthCells + 2) x (NumWidthCells + 2) x (NumHeightCells + 2))의 확산 방정식을 이완법으로 풉니다.
+**/
+class HEATBOX_API HeatSolver
+{
+public:
+	HeatSolver()
+	{}
+
+	HeatSolver(int NumDepthCells, int NumWidthCells, int NumHeightCells, float HeatTransferRate);
+
+	/**
+	* 기준(직렬) 스윕. 기존 AHeatmap::Diffuse 루프와 동일한 순서로 갱신합니다.
+	* 반환값은 이번 스윕에서 가장 크게 변한 셀의 변화량(잔차 노름)입니다.
+	**/
+	float RelaxSerial(const TArray<float>& Source, TArray<float>& Field) const;
+
+	/**
+	* Z 슬랩 단위로 분할하여 워커 스레드에서 스윕합니다.
+	* 슬랩 경계 평면은 스윕 시작 시점의 값(halo)을 읽으므로 직렬 결과와 오차 범위 내에서 일치합니다.
+	**/
+	float RelaxParallel(const TArray<float>& Source, TArray<float>& Field, int NumSlabs = 0);
+
+	/**
+	* 셀(맵 인덱스 기준)이 속한 브릭을 활성화합니다.
+	**/
+	void MarkCellActive(int X, int Y, int Z);
+
+	/**
+	**/
+	void ResetBricks();
+
+	/**
+	* 활성 브릭과 그 주변 한 브릭(halo)을 이번 틱의 스윕 대상으로 확정하고 개수를 반환합니다.
+	**/
+	int BeginSparseSolve();
+
+	/**
+	* 스윕 대상 브릭만 이완합니다. 병렬 스윕은 서로 인접하지 않는 8가지 브릭 색상 순으로 진행합니다.
+	**/
+	float RelaxSparse(const TArray<float>& Source, TArray<float>& Field, bool bParallel);
+
+	/**
+	* 스윕 대상 브릭의 활성 여부를 갱신합니다. Threshold 이하로 식은 브릭은 0으로 비우고 비활성화합니다.
+	**/
+	void EndSparseSolve(TArray<float>& Field, float Threshold);
+
+	/**
+	**/
+	int GetNumActiveBricks() const;
+
+	/**
+	* OutResidual = Source - A * Field 를 계산하고 (1 + 6 * HeatTransferRate)로 정규화한 최대 잔차를 반환합니다.
+	**/
+	float ComputeResidual(const TArray<float>& Source, const TArray<float>& Field, TArray<float>& OutResidual) const;
+
+	/**
+	**/
+	int GetNumSlabs(int RequestedSlabs) const;
+
+	/**
+	**/
+	int GetFieldSize() const;
+
+	int GetNumDepthCells() const { return NumDepthCells; }
+	int GetNumWidthCells() const { return NumWidthCells; }
+	int GetNumHeightCells() const { return NumHeightCells; }
+
+	/**
+	**/
+	int CoreIndex(int i, int j, int k) const;
+
+	static constexpr int BrickSize = 8;
+
+private:
+	/**
+	**/
+	float RelaxPlane(const float* Source, float* Field, const float* Below, const float* Above) const;
+
+	/**
+	**/
+	float RelaxBrick(int Brick, const TArray<float>& Source, TArray<float>& Field) const;
+
+	/**
+	**/
+	int BrickIndex(int BX, int BY, int BZ) const;
+
+private:
+	int NumDepthCells = 0;
+	int NumWidthCells = 0;
+	int NumHeightCells = 0;
+	float HeatTransferRate = 0.f;
+
+	int PlaneSize = 0;
+
+	// 슬랩마다 아래/위 halo 평면 두 장
+	TArray<float> HaloPlanes;
+
+	TArray<float> SlabResiduals;
+
+	int NumBricksX = 0;
+	int NumBricksY = 0;
+	int NumBricksZ = 0;
+
+	TArray<uint8> BrickActive;
+
+	// 이번 틱에 스윕할 브릭 (활성 + halo)
+	TArray<int> SweepBricks;
+
+	TArray<float> BrickResiduals;
+};
+
+/**
+* 기하 멀티그리드(V-cycle) 솔버
+* 각 레벨은 동일한 패딩 레이아웃을 사용하며, 격자 간격이 두 배가 될 때마다 열 전달률은 1/4로 줄어듭니다.
+**/
+class HEATBOX_API HeatMultigrid
+{
+public:
+	HeatMultigrid()
+	{}
+
+	HeatMultigrid(int NumDepthCells, int NumWidthCells, int NumHeightCells, float HeatTransferRate, int MaxLevels = 8);
+
+	/**
+	* V-cycle 한 번을 수행하고 마지막 후평활 스윕의 최대 변화량을 반환합니다.
+	**/
+	float VCycle(const TArray<float>& Source, TArray<float>& Field, bool bParallel, int NumSlabs = 0);
+
+	/**
+	**/
+	int GetNumLevels() const;
+
+	/**
+	**/
+	bool IsValid() const;
+
+private:
+	struct FGridLevel
+	{
+		HeatSolver Solver;
+		TArray<float> Field;
+		TArray<float> Source;
+		TArray<float> Residual;
+	};
+
+	/**
+	**/
+	float Relax(int Level, const TArray<float>& Source, TArray<float>& Field, bool bParallel, int NumSlabs);
+
+	/**
+	* 미세 격자 잔차를 자식 셀 평균으로 거친 격자에 옮깁니다.
+	**/
+	void Restrict(int FineLevel, const TArray<float>& FineResidual);
+
+	/**
+	* 거친 격자 보정값을 부모 셀 값 그대로 미세 격자에 더합니다.
+	**/
+	void Prolongate(int FineLevel, TArray<float>& FineField) const;
+
+private:
+	TArray<FGridLevel> Levels;
+
+	int NumPreSmooth = 2;
+	int NumPostSmooth = 2;
+};
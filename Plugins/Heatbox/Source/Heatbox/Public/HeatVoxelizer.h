@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UStaticMeshComponent;
+class UPrimitiveComponent;
+
+/**
+* 스태틱 메쉬의 삼각형을 히트맵 셀 단위로 나누어 셀별 표면 샘플을 굽습니다.
+* 삼각형 위의 점을 면적에 비례하여 뽑고 점이 속한 셀로 분류하므로, 여러 셀에 걸친 삼각형은 셀 경계에서 잘린 것과 같습니다.
+**/
+class HEATBOX_API HeatVoxelizer
+{
+public:
+	HeatVoxelizer()
+	{}
+
+	HeatVoxelizer(const FTransform& HeatmapTransform, int NumDepthCells, int NumWidthCells, int NumHeightCells, int SamplesPerCell);
+
+	/**
+	* LOD0 삼각형을 샘플링합니다. 렌더 데이터가 없거나 CPU에서 읽을 수 없는 메쉬면 false를 반환합니다.
+	**/
+	bool AddStaticMesh(const UStaticMeshComponent* MeshComp);
+
+	/**
+	* 셀마다 최대 SamplesPerCell개의 월드 좌표 샘플을 고르게 골라 반환합니다.
+	**/
+	void GetSurfaceSamples(TMap<FIntVector, TArray<FVector>>& OutSamplesAt) const;
+
+	/**
+	**/
+	void Reset();
+
+	/**
+	* 충돌체의 경계 상자를 셀 범위로 래스터화하고, 충돌체와 실제로 겹치는 셀 중 InOutRasterized에 없는 셀을 추가합니다.
+	* OutOccupancy가 있으면 셀을 OccupancySubdivisions^3 개의 작은 상자로 나누어 겹치는 부피 비율을 함께 추정합니다.
+	* 후보 셀을 바꾸지 않으므로 액터별로 워커 스레드에서 호출할 수 있습니다.
+	**/
+	void RasterizeCollision(const UPrimitiveComponent* PrimComp, TSet<FIntVector>& InOutRasterized, TArray<FIntVector>& OutMapIndices, TArray<float>* OutOccupancy) const;
+
+	static constexpr int OccupancySubdivisions = 4;
+
+private:
+	/**
+	* 히트맵 로컬 좌표가 속한 셀. 맵 밖이면 false
+	**/
+	bool GetCellIndex(const FVector& LocalPos, FIntVector& OutMapIndex) const;
+
+private:
+	FTransform HeatmapTransform;
+
+	int NumDepthCells = 0;
+	int NumWidthCells = 0;
+	int NumHeightCells = 0;
+	int SamplesPerCell = 0;
+
+	// 셀 면적당 SamplesPerCell의 몇 배를 뽑을지
+	static constexpr int Oversampling = 4;
+
+	// 셀별 후보 샘플 (히트맵 로컬 좌표)
+	TMap<FIntVector, TArray<FVector>> CandidatesAt;
+};
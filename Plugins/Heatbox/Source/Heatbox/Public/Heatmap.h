@@ -5,12 +5,24 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Containers/Map.h"
+#include "WorldCollision.h"
+#include "HeatSolver.h"
+#include "FireRegionLabeler.h"
+#include "Async/Future.h"
 #include "Heatmap.generated.h"
 
 using namespace std;
 
 #define HITQUERY_REQ 12 
 #define HITQUERY_TOLERANCE 256
+#define HITQUERY_SLOT_BITS 24
+#define HITQUERY_GEN_BITS 5
+
+class UHeatRegistryAsset;
+class UNiagaraSystem;
+class UFireInstanceComponent;
+class AHeatmap;
+struct FBakedBoxOwner;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHeatBox_OnBodyHalfBurnt, AActor*, BoxOwner);
 
@@ -25,7 +37,7 @@ struct FFlammableBoxInsts
 	{}
 
 	UPROPERTY(VisibleAnywhere)
-	TArray<FIntVector> Indices;
+	TArray<int> Slots;
 
 
 };
@@ -41,7 +53,18 @@ struct FBurningBoxInsts
 	{}
 
 	UPROPERTY(VisibleAnywhere)
-	TArray<FIntVector> Indices;
+	TArray<int> Slots;
+
+	// 마지막 화염 집계에서 찾은 화염 범위의 시그니처
+	TArray<uint64> FireSignatures;
+};
+
+UENUM()
+enum class FireEffectLOD : uint8
+{
+	Full,
+	Paused,
+	Hidden,
 };
 
 /**
@@ -56,23 +79,53 @@ struct FFireInBox
 
 	~FFireInBox();
 
-	explicit FFireInBox(const TArray<FIntVector>& BoxIndices)
-		: BoxIndices(BoxIndices)
+	explicit FFireInBox(uint64 Signature, const TArray<FIntVector>& BoxIndices, const TArray<int>& BoxSlots)
+		: Signature(Signature),
+		BoxIndices(BoxIndices),
+		BoxSlots(BoxSlots)
 	{}
 
 	bool operator==(const FFireInBox& other)
 	{
-		return BoxIndices == other.BoxIndices;
+		return Signature == other.Signature;
 	}
 	
 	void SetFireSize(float Size);
 
+	/**
+	* 이펙트 표현만 바꿉니다. 화염 범위의 시뮬레이션 상태는 그대로입니다.
+	**/
+	void SetEffectLOD(FireEffectLOD NewLOD);
+
 	UPROPERTY()
 	TObjectPtr<AFireBlob> FireEffect;
 
+	UPROPERTY()
+	FireEffectLOD EffectLOD = FireEffectLOD::Full;
+
+	// 화염이 사라질 때 이펙트를 돌려받을 히트맵. 없으면 이펙트를 파괴합니다.
+	TWeakObjectPtr<AHeatmap> EffectPool;
+
+	// 마지막으로 반영한 화염 크기 배율과 세기 (0~1)
+	float FireSize = 1.f;
+
+	float Intensity = 0.f;
+
+	// 소유자와 셀 집합으로 정해지는 화염 범위 식별자
+	UPROPERTY()
+	uint64 Signature = 0;
+
+	// 마지막으로 집계된 화염 집계 세대
+	UPROPERTY()
+	uint32 Generation = 0;
+
 	UPROPERTY()
 	TArray<FIntVector> BoxIndices;
 
+	// BoxIndices와 같은 순서의 셀 슬롯
+	UPROPERTY()
+	TArray<int> BoxSlots;
+
 	UPROPERTY()
 	FVector SpawnLocation;
 
@@ -94,163 +147,263 @@ struct FHeatBoxInfoDefaultInit {
 };
 
 /**
+* 액터 단위로 공유되는 재질 상수
 **/
 USTRUCT()
-struct FHeatBoxInfo
+struct FHeatBoxMaterial
 {
 	GENERATED_BODY()
 
-	FHeatBoxInfo()
+	FHeatBoxMaterial()
 	{}
 	
-	explicit FHeatBoxInfo(const FHeatBoxInfoDefaultInit& HeatBoxInfoInit) :
-		CurrTemperature(HeatBoxInfoInit.CurrTemperature),
+	explicit FHeatBoxMaterial(const FHeatBoxInfoDefaultInit& HeatBoxInfoInit) :
 		MaxTemperature(HeatBoxInfoInit.MaxTemperature),
 		IgnitionPoint(HeatBoxInfoInit.IgnitionPoint),
 		HeatAbsorbRate(HeatBoxInfoInit.HeatAbsorbRate),
 		HeatEmitRate(HeatBoxInfoInit.HeatEmitRate),
 		FuelCount(HeatBoxInfoInit.FuelCount),
-		RadiationArea(HeatBoxInfoInit.RadiationArea),
 		MinFireSize(HeatBoxInfoInit.MinFireSize),
-		MaxFireSize(HeatBoxInfoInit.MaxFireSize),
-		IsBurning(HeatBoxInfoInit.IsBurning)
+		MaxFireSize(HeatBoxInfoInit.MaxFireSize)
 		{}
 
-
-	explicit FHeatBoxInfo(float MaxTemperature,
-		float IgnitionPoint,
-		float HeatAbsorbRate,
-		float HeatEmitRate,
-		float FuelCount,
-		float MinFireSize,
-		float MaxFireSize,
-		float RadiationArea,
-		bool IsBurning) :
-		MaxTemperature(MaxTemperature),
-		IgnitionPoint(IgnitionPoint),
-		HeatAbsorbRate(HeatAbsorbRate),
-		HeatEmitRate(HeatEmitRate),
-		FuelCount(FuelCount),
-		RadiationArea(RadiationArea),
-		MinFireSize(MinFireSize),
-		MaxFireSize(MaxFireSize),
-		IsBurning(IsBurning)
-		{}
-	
-	/**
-	* 열 전달 방정식
-	* 온도 변화량 = 열 에너지 x 열 흡수율
-	*/
-	void ReceiveHeat(float HeatEnergy, float UpdateInterval);
-	
-	/**
-	* 흑체(Black-body) 방정식
-	* 열 에너지 = 열 방출율 x 슈테판-볼츠만 상수 x (최대 온도[K]^4 - (최대 온도 - 현재 온도)[K]^4) x 방열 면적[m^2]
-	*/
-	float RadiateHeat();
-
-	bool IsBurntOut() const;
-
-	bool IsIgnitionStarting() const;
-	
-	bool IsExtinguished() const;
-
-	FVector ClampFireSize(float EstimatedArea) const;
-
-	/*
-	*/
-	UPROPERTY(VisibleAnywhere)
-	float CurrTemperature;
-
 	/** 
 	* The maximum temperature that a substance undergoing a combustion reaction can reach 
 	*/
 	UPROPERTY(EditAnywhere)
-	float MaxTemperature;
+	float MaxTemperature = 1000.f;
 
 	/** 
 	* The temperature at which the combustion reaction of a substance starts 
 	*/
 	UPROPERTY(EditAnywhere)
-	float IgnitionPoint;
+	float IgnitionPoint = 100.f;
 
 	/** 
 	* Inherent heat energy absorption efficiency of a material 
 	*/
 	UPROPERTY(EditAnywhere)
-	float HeatAbsorbRate;
+	float HeatAbsorbRate = 1.f;
 	
 	/**
 	* Inherent heat energy release efficiency of a material
 	*/
 	UPROPERTY(EditAnywhere)
-	float HeatEmitRate;
+	float HeatEmitRate = 1.f;
 
 	/**
-	* Remaining fuel or combustion rate of the material in which the combustion reaction took place
+	* Initial fuel of each cell of the material
 	*/
 	UPROPERTY(EditAnywhere)
-	float FuelCount;
-
-	/**
-	* The surface area of ​​the material where the combustion reaction took place
-	* This parameter is applied to the black-body equation that calculates the amount of heat that causes damage or increases the temperature of nearby players and objects.
-	*/
-	UPROPERTY(VisibleAnywhere)
-	float RadiationArea;
+	float FuelCount = 40.f;
 
 	/** 
 	* Adjust the minimum size of the effect to visualize the combustion reaction 
 	*/
 	UPROPERTY(EditAnywhere)
-	float MinFireSize;
+	float MinFireSize = 0.4f;
 
 	/**
 	* Adjust the maximum size of the effect visualizing the combustion reaction 
 	*/
 	UPROPERTY(EditAnywhere)
-	float MaxFireSize;
+	float MaxFireSize = 2.f;
+};
+
+/**
+**/
+USTRUCT()
+struct FHeatBox
+{
+	GENERATED_BODY()
+	
+	// 액터별 셀 슬롯 (FHeatCellStore)
+	UPROPERTY(VisibleAnywhere)
+	TMap<AActor*, int> SlotOf;
+};
+
+/**
+**/
+UENUM()
+enum class HeatCellPhase : uint8
+{
+	None,
+	Flammable,
+	Burning,
+	BurntOut,
+};
+
+/**
+* (셀, 액터) 슬롯 단위의 조밀한 셀 저장소
+* 매 업데이트마다 접근하는 필드는 슬롯 핸들로 인덱싱하는 SoA 배열에 연속으로 저장합니다.
+* HeatBoxAt 조회는 등록, 등록 취소와 API 경계에서만 사용합니다. 화염 영역의 이웃 탐색은 FireRegionLabeler가 점유 격자 위에서 합니다.
+**/
+struct FHeatCellStore
+{
+	/**
+	* 액터에 정수 핸들을 부여하고 재질 레코드를 만듭니다.
+	**/
+	int AddOwner(AActor* InBoxOwner, const FHeatBoxMaterial& Material);
+
+	/**
+	* 등록되지 않은 액터는 INDEX_NONE을 반환합니다.
+	**/
+	int FindOwner(const AActor* InBoxOwner) const;
+
+	/**
+	**/
+	int GetNumOwners() const;
+
+	/**
+	* 빈 슬롯을 재사용하여 셀을 추가하고 슬롯 핸들을 반환합니다.
+	**/
+	int AddCell(const FIntVector& InMapIndex, int InCoreIdx, int InOwnerHandle, const FHeatBoxInfoDefaultInit& HeatBoxInfoInit);
+
+	/**
+	**/
+	void RemoveCell(int Slot);
+
+	/**
+	* 소유자의 모든 셀을 한 번에 제거합니다. 표면 샘플 풀 정리도 마지막에 한 번만 합니다.
+	**/
+	void RemoveOwnerCells(int Handle);
+
+	/**
+	* 소유자 핸들을 비웁니다. 핸들은 재사용하지 않으며, 셀은 먼저 RemoveCell 또는 RemoveOwnerCells로 제거해야 합니다.
+	**/
+	void RemoveOwner(int Handle);
+
+	/**
+	**/
+	bool IsValidSlot(int Slot) const;
+
+	/**
+	**/
+	int GetNumSlots() const;
+
+	/**
+	**/
+	void Reset();
+
+	/**
+	* 열 전달 방정식
+	* 온도 변화량 = 열 에너지 x 열 흡수율
+	*/
+	void ReceiveHeat(int Slot, float HeatEnergy, float UpdateInterval);
 
 	/**
-	* Adjust the maximum size of the effect visualizing the combustion reaction
+	* 열 전달 방정식의 온도 변화량만 계산합니다. (게임 스레드 밖에서 사용)
 	*/
-	UPROPERTY(VisibleAnywhere)
-	float HeatDamageApplied;
-	
+	static float ComputeReceivedHeat(float HeatEnergy, float UpdateInterval, float HeatAbsorbRate);
+
 	/**
-	* Adjust the maximum size of the effect visualizing the combustion reaction
 	*/
-	UPROPERTY(VisibleAnywhere)
-	float HeatDamageReceived;
+	void ApplyReceivedHeat(int Slot, float Received);
 
 	/**
-	* The fire point of a substance in which a combustion reaction has taken place
+	* 흑체(Black-body) 방정식
+	* 열 에너지 = 열 방출율 x 슈테판-볼츠만 상수 x (최대 온도[K]^4 - (최대 온도 - 현재 온도)[K]^4) x 방열 면적[m^2]
 	*/
-	UPROPERTY(VisibleAnywhere)
-	FVector IgnitionCore;
+	float RadiateHeat(int Slot);
 
-	UPROPERTY(VisibleAnywhere)
-	bool IsBurning;
+	bool IsBurntOut(int Slot) const;
 
-	UPROPERTY()
-	int HitQueryCount = HITQUERY_REQ;
+	bool IsIgnitionStarting(int Slot) const;
 
-	UPROPERTY()
-	TArray<FVector> HitPoints;
+	bool IsExtinguished(int Slot) const;
 
-	UPROPERTY()
-	bool Visited = false;
-};
+	FVector ClampFireSize(int Slot, float EstimatedArea) const;
 
-/**
-**/
-USTRUCT()
-struct FHeatBox
-{
-	GENERATED_BODY()
-	
-	UPROPERTY(VisibleAnywhere)
-	TMap<AActor*, FHeatBoxInfo> InstInfoOf;
+	/**
+	* 등록 시 구운 표면 샘플을 셀에 연결합니다. 이 셀은 런타임 트레이스를 하지 않습니다.
+	**/
+	void SetSurfaceSamples(int Slot, const TArray<FVector>& Samples);
+
+	/**
+	* 구운 표면 샘플이 있으면 그 구간을, 없으면 트레이스로 찾은 히트 포인트를 반환합니다.
+	**/
+	TConstArrayView<FVector> GetHitPoints(int Slot) const;
+
+	FORCEINLINE const FHeatBoxMaterial& GetMaterial(int Slot) const
+	{
+		return Materials[OwnerHandle[Slot]];
+	}
+
+	FORCEINLINE AActor* GetBoxOwner(int Slot) const
+	{
+		return Owners[OwnerHandle[Slot]];
+	}
+
+	/**
+	* 소유자의 모든 유효 슬롯 (위상과 무관, 순서 보장 없음)
+	**/
+	FORCEINLINE const TArray<int>& GetOwnerSlots(int Handle) const
+	{
+		return SlotsOf[Handle];
+	}
+
+	// 액터 핸들별 레코드
+	TArray<AActor*> Owners;
+	TArray<FHeatBoxMaterial> Materials;
+
+	// 액터 핸들 x 6: 셀 면별 트레이스 히트 가중치
+	TArray<float> FaceHitWeights;
+
+	// 핫 필드
+	TArray<float> CurrTemperature;
+	TArray<float> FuelCount;
+	TArray<bool> IsBurning;
+	TArray<int> OwnerHandle;
+
+	// 슬롯 정보
+	TArray<FIntVector> MapIndex;
+	TArray<int> CoreIdx;
+	TArray<HeatCellPhase> Phase;
+
+	// 콜드 필드
+	TArray<float> RadiationArea;
+	TArray<float> HeatDamageApplied;
+	TArray<float> HeatDamageReceived;
+	TArray<FVector> IgnitionCore;
+	TArray<int> HitQueryCount;
+	TArray<int> HitQueryAttempts;
+	TArray<int> HitQueryInFlight;
+	TArray<TArray<FVector>> HitPoints;
+
+	// 슬롯이 비워질 때마다 증가합니다. 재사용된 슬롯에 이전 셀의 트레이스 결과가 들어오는 것을 막습니다.
+	TArray<uint8> SlotGeneration;
+
+	// 셀 부피 중 소유자 충돌체가 차지하는 비율 (계산하지 않으면 1)
+	TArray<float> Occupancy;
+
+	// 구운 표면 샘플: 셀마다 SurfaceSamples의 [Start, Start + Count) 구간
+	TArray<int> SurfaceSampleStart;
+	TArray<int> SurfaceSampleCount;
+	TArray<FVector> SurfaceSamples;
+
+private:
+	TArray<int> FreeSlots;
+
+	TMap<const AActor*, int> HandleOf;
+
+	// 액터 핸들별 슬롯 목록
+	TArray<TArray<int>> SlotsOf;
+
+	// 슬롯별 SlotsOf[OwnerHandle] 안의 위치
+	TArray<int> SlotListIndex;
+
+	// SurfaceSamples 중 제거되거나 교체된 셀이 남긴 샘플 수
+	int NumDeadSurfaceSamples = 0;
+
+	/**
+	* 죽은 샘플이 풀의 절반을 넘으면 살아 있는 구간만 앞으로 모읍니다.
+	**/
+	void CompactSurfaceSamples();
+
+	/**
+	* 슬롯을 비우고 빈 슬롯 목록에 넣습니다. 소유자 슬롯 목록은 호출자가 정리합니다.
+	**/
+	void ClearSlot(int Slot);
 };
 
 /**
@@ -318,6 +471,146 @@ enum class SimStage : uint8
 	Paused	= 1 << 1,
 };
 
+/**
+* UpdatePhaseTransitions 순회 중 기록되는 위상 변화
+**/
+struct FHeatCellTransition
+{
+	FHeatCellTransition(int Slot, HeatCellPhase NewPhase)
+		: Slot(Slot),
+		NewPhase(NewPhase)
+	{}
+
+	int Slot;
+
+	HeatCellPhase NewPhase;
+};
+
+/**
+* 백그라운드 시뮬레이션에 넘기는 셀 상태 사본
+**/
+struct FHeatCellSnapshot
+{
+	FHeatCellSnapshot(int Slot, int OwnerHandle, int CoreIdx, float HeatAbsorbRate)
+		: Slot(Slot),
+		OwnerHandle(OwnerHandle),
+		CoreIdx(CoreIdx),
+		HeatAbsorbRate(HeatAbsorbRate)
+	{}
+
+	int Slot;
+
+	// 결과 반영 시 슬롯 검증에 사용합니다.
+	int OwnerHandle;
+
+	int CoreIdx;
+
+	float HeatAbsorbRate;
+
+	float HeatDamageReceived = 0.f;
+};
+
+/**
+**/
+UENUM()
+enum class DiffusionSolver : uint8
+{
+	Relaxation,
+	Multigrid,
+};
+
+/**
+* 확산 한 번에 쓰는 솔버 설정
+* 확산을 시작할 때 게임 스레드에서 속성을 복사하므로, 진행 중인 확산은 도중에 바뀐 속성을 읽지 않습니다.
+**/
+struct FHeatDiffuseSettings
+{
+	DiffusionSolver SolverType = DiffusionSolver::Relaxation;
+
+	bool bParallel = false;
+
+	// Relaxation 모드에서만 켜집니다.
+	bool bSparse = false;
+
+	int NumSlabs = 0;
+
+	float Tolerance = 0.f;
+
+	int MinIterations = 1;
+
+	int MaxIterations = 1;
+
+	float ActiveBrickThreshold = 0.f;
+
+#if WITH_EDITOR
+	bool bValidateParallel = false;
+
+	float ValidationTolerance = 0.f;
+#endif
+};
+
+/**
+**/
+struct FHeatDiffuseStats
+{
+	int Iterations = 0;
+
+	float Residual = 0.f;
+
+	// 수렴 판정 기준: 확산 시작 시점 필드의 최대 절댓값
+	float FieldScale = 0.f;
+
+	int NumActiveBricks = 0;
+};
+
+/**
+* 히트필드 백 버퍼
+**/
+struct FHeatSimBuffer
+{
+	TArray<float> Field;
+
+	TArray<float> Accumulator;
+
+	TArray<FHeatCellSnapshot> Cells;
+
+	// 태스크는 멤버 속성 대신 시작 시점에 복사한 설정만 읽습니다.
+	FHeatDiffuseSettings DiffuseSettings;
+
+	float UpdateInterval = 0.f;
+
+	FHeatDiffuseStats DiffuseStats;
+};
+
+/**
+* 시간 분할 업데이트 파이프라인 단계
+**/
+UENUM()
+enum class SimPipelineStage : uint8
+{
+	Idle,
+	Transition,
+	Trace,
+	Fire,
+	Diffuse,
+	Damage,
+	Post,
+};
+
+UENUM()
+enum class HitQuerySamplerType : uint8
+{
+	Random,
+	Stratified,
+};
+
+UENUM()
+enum class FirePresentationMode : uint8
+{
+	Actors,
+	Instanced,
+};
+
 UENUM() 
 enum class SetHeatBoxFuncParamType : uint8
 {
@@ -345,6 +638,12 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	// 시간 분할 모드에서만 활성화됩니다.
+	virtual void Tick(float DeltaTime) override;
+
 public:
 	/**
 	**/
@@ -356,6 +655,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
 	void ClearRegistry();
 
+	/**
+	* 액터 하나를 등록합니다. 전체 겹침 쿼리 없이 액터의 충돌체가 덮는 셀만 래스터화합니다.
+	* 히트맵과 겹치는 가연성 충돌체가 없거나 이미 등록된 액터면 false를 반환합니다.
+	**/
+	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
+	bool RegisterBoxOwner(AActor* BoxOwner);
+
+	/**
+	* 액터의 모든 셀과 화염을 레지스트리에서 제거합니다.
+	**/
+	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
+	void UnregisterBoxOwner(AActor* BoxOwner);
+
 	/**
 	* 시뮬레이션을 시작합니다.
 	**/
@@ -411,64 +723,353 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
 	float GetBodyTemperature(AActor* BoxOwner) const;
 
+	/**
+	* 현재 등록된 액터 목록 (등록 취소된 핸들 제외)
+	**/
+	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
+	void GetRegisteredBoxOwners(TArray<AActor*>& OutBoxOwners) const;
+
 private:
 	/**
 	* 시뮬레이션을 적용할 액터를 등록합니다.
 	**/
 	void RegisterNewBoxOwners_Impl(TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
 						TMap<AActor*, FBurningBoxInsts>& OutBurnBoxInstsOf,
-						TMap<FIntVector, FHeatBox>& OutHeatBoxAt);
-	
+						TMap<FIntVector, FHeatBox>& OutHeatBoxAt,
+						FHeatCellStore& OutCellStore);
+
 	/**
+	* 주어진 액터들을 복셀화하여 등록합니다. 이미 등록된 액터는 건너뜁니다.
 	**/
-	UFUNCTION(Category="Helper Functions", CallInEditor, meta = (EditCondition = "!bSimHasBegun"))
-	void Apply();
+	void RegisterBoxOwners_Impl(TArray<AActor*>& BoxOwners,
+						TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
+						TMap<FIntVector, FHeatBox>& OutHeatBoxAt,
+						FHeatCellStore& OutCellStore);
 
 	/**
+	* BakedRegistry가 현재 히트맵 배치, 액터 GUID, 액터 트랜스폼과 일치하면 레지스트리를 복원합니다.
+	* 하나라도 맞지 않으면 아무것도 등록하지 않고 false를 반환합니다.
 	**/
-	void RouteUpdateHeatmap();
-	
-	/** 
-	**/
-	void PreUpdateHeatmap();
+	bool LoadBakedRegistry(TMap<AActor*, FFlammableBoxInsts>& OutFlamBoxInstsOf,
+						TMap<FIntVector, FHeatBox>& OutHeatBoxAt,
+						FHeatCellStore& OutCellStore);
 
 	/**
+	* 구운 액터 경로를 현재 월드(PIE 포함)의 액터로 찾습니다.
 	**/
-	void UpdateHeatmap();
+	AActor* ResolveBakedActor(const TSoftObjectPtr<AActor>& BakedActor) const;
 
 	/**
+	* 겹침 쿼리로 찾은 가연성 액터 중 구울 때 없던 액터를 런타임에 등록합니다.
 	**/
-	void PostUpdateHeatmap();
+	void RegisterUnbakedActors();
 
 	/**
+	* bAutoRegisterActors일 때 스폰된 액터를 다음 틱 등록 대기열에 넣습니다.
 	**/
-	void TraceBoxOwner(const FIntVector& BoxIndex, AActor* const BoxOwner, int& CurrentHitCount, ECollisionChannel Boxtype);
+	void OnActorSpawned(AActor* SpawnedActor);
 
 	/**
+	* 초기화가 끝난 대기 액터 중 가연성 충돌체가 있는 액터를 등록합니다. 아직 스폰 중인 액터는 다음 틱으로 미룹니다.
 	**/
-	void AggregateHitPoints(const FIntVector& BaseIndex, const AActor* BoxOwner, TArray<FIntVector>& AggregatorIndices, TArray<FVector>& AggregatedHitPoints);
+	void RegisterSpawnedActors();
 
 	/**
 	**/
-	void Diffuse(TArray<float>& Field);
+	UFUNCTION()
+	void OnBoxOwnerDestroyed(AActor* DestroyedActor);
 
+public:
 	/**
+	* 풀에서 화염 이펙트를 꺼내 배치합니다. 풀이 비었으면 새로 스폰합니다.
 	**/
-	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
-	bool GetMapIndex(const FVector& WorldPos, FIntVector& OutMapIndex) const;
+	AFireBlob* AcquireFireEffect(const FTransform& SpawnTransform);
 
 	/**
+	* 화염 이펙트를 숨겨 풀에 돌려놓습니다.
 	**/
-	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
-	void GetMapWorldPos(const FIntVector& MapIndex, FVector& WorldPos) const;
+	void ReleaseFireEffect(AFireBlob* FireEffect);
 
+private:
 	/**
+	* 풀의 여유 이펙트가 FireEffectPoolSize개가 되도록 미리 스폰합니다.
 	**/
-	int CoreIndex(int i, int j, int k) const;
+	void PrewarmFireEffects();
 
 	/**
+	* Instanced 모드에서 진행 중인 모든 화염을 FireInstances에 한 번에 씁니다.
 	**/
-	int MapToCoreIndex(const FIntVector& MapIndex) const;
+	void FlushFireInstances();
+
+	/**
+	* PostUpdateBoxOwner가 모은 화염 크기 변경을 한 번에 반영합니다.
+	**/
+	void ApplyFireSizes();
+
+	/**
+	* 화염을 (크기 / 가장 가까운 시점까지의 거리) 순으로 정렬하여 상위 MaxFullQualityFires개만 재생하고,
+	* 나머지는 정지, FireEffectCullDistance 밖의 화염은 숨깁니다.
+	**/
+	void UpdateFireEffectLOD();
+	
+	/**
+	**/
+	UFUNCTION(Category="Helper Functions", CallInEditor, meta = (EditCondition = "!bSimHasBegun"))
+	void Apply();
+
+	/**
+	* 32³, 64³, 128³ 격자에서 기존 20회 이완과 멀티그리드의 틱당 비용을 비교하여 로그로 출력합니다.
+	**/
+	UFUNCTION(Category = "Helper Functions", CallInEditor)
+	void BenchmarkDiffusion();
+
+	/**
+	* 현재 레벨의 등록 결과를 BakedRegistry 에셋에 굽습니다.
+	**/
+	UFUNCTION(Category = "Helper Functions", CallInEditor, meta = (EditCondition = "!bSimHasBegun"))
+	void BakeRegistry();
+
+	/**
+	* 수천 개의 등록 셀에서 기존 방식(레지스트리 복사 + TArray::Remove)과 위상 변화 큐 + 압축 방식의 비용을 비교하여 로그로 출력합니다.
+	**/
+	UFUNCTION(Category = "Helper Functions", CallInEditor)
+	void BenchmarkPhaseTransitions();
+
+	/**
+	**/
+	UFUNCTION(Category = "Helper Functions", CallInEditor)
+	void ResetHitQueryStats();
+
+	/**
+	* 등록된 셀에서 레이마다 무시 목록을 새로 만드는 기존 방식과 소유자별 캐시 방식의 초당 트레이스 수를 비교하여 로그로 출력합니다.
+	* 먼저 액터를 등록해야 합니다.
+	**/
+	UFUNCTION(Category = "Helper Functions", CallInEditor)
+	void BenchmarkHitQueries();
+
+	/**
+	**/
+	void RouteUpdateHeatmap();
+	
+	/** 
+	**/
+	void PreUpdateHeatmap();
+
+	/**
+	**/
+	void UpdateHeatmap();
+
+	/**
+	**/
+	void PostUpdateHeatmap();
+
+	/**
+	* 화염 범위 집계, 이펙트 생성/소멸, 연소 열 방출
+	**/
+	void UpdateFires();
+
+	/**
+	**/
+	void UpdateHeatVisuals();
+
+	/**
+	* 모든 셀에 히트필드 열을 반영합니다.
+	**/
+	void ApplyHeatDamage();
+
+	/**
+	**/
+	void AccumulateHeat(TArray<float>& Field, TArray<float>& Accumulator) const;
+
+	/**
+	* AddHeat/RadiateHeat로 열이 입력된 셀의 브릭을 활성화합니다.
+	**/
+	void FlushHeatInputs();
+
+	/**
+	**/
+	void ApplyDiffuseStats(const FHeatDiffuseStats& DiffuseStats);
+
+	/**
+	* 연소/소화/전소 위상 변화를 처리합니다.
+	**/
+	void UpdatePhaseTransitions();
+
+	/**
+	* 기록된 위상 변화를 반영하고 레지스트리를 한 번에 압축합니다.
+	**/
+	void ApplyPhaseTransitions();
+
+	/**
+	**/
+	void GatherBurningBoxes(TArray<int>& OutBurningSlots) const;
+
+	/**
+	**/
+	void GatherRegisteredBoxes(TArray<int>& OutSlots) const;
+
+	/**
+	* 연소 중인 셀 하나의 표면 히트 포인트를 찾습니다.
+	**/
+	void TraceBurningBox(int Slot);
+
+	/**
+	**/
+	void BeginFireAggregation();
+
+	/**
+	**/
+	void AggregateFiresOf(AActor* BoxOwner);
+
+	/**
+	**/
+	void EndFireAggregation();
+
+	/**
+	**/
+	void ApplyHeatDamageAt(int Slot);
+
+	/**
+	**/
+	void PostUpdateBoxOwner(AActor* BoxOwner);
+
+	/**
+	* 시간 분할 모드: 새 시뮬레이션 스텝을 시작합니다.
+	**/
+	void BeginPipelineStep();
+
+	/**
+	* 시간 분할 모드: 프레임 예산(TimeSliceBudgetMs)만큼 파이프라인을 진행합니다.
+	**/
+	void AdvancePipeline();
+
+	/**
+	**/
+	void EnterPipelineStage(SimPipelineStage NextStage);
+
+	/**
+	**/
+	void RunPipelineUnit();
+
+	/**
+	* SliceSlots를 모은 시점의 슬롯 세대를 기록합니다.
+	**/
+	void CaptureSliceSlotGenerations();
+
+	/**
+	* 작업 목록을 모은 뒤 등록 취소되었거나 다른 셀에 재사용된 슬롯이면 false를 반환합니다.
+	**/
+	bool IsSliceSlotCurrent(int Index) const;
+
+	/**
+	* 히트필드와 셀 상태를 백 버퍼로 복사하고 수치 연산을 백그라운드 태스크로 시작합니다.
+	**/
+	void LaunchHeatSimTask();
+
+	/**
+	* 백그라운드 태스크 결과를 반영하고 PostUpdate를 수행합니다.
+	**/
+	void CompleteHeatSimTask();
+
+	/**
+	**/
+	void TraceBoxOwner(int Slot, int& CurrentHitCount, ECollisionChannel Boxtype);
+
+	/**
+	* 박스 표면에서 중심 방향으로 향하는 트레이스 구간. SampleIndex는 셀의 샘플 수열 위치입니다.
+	* 시작점을 고른 면을 반환합니다. (Random 모드에서는 INDEX_NONE)
+	**/
+	int GetHitQuerySegment(int Slot, uint32 SampleIndex, FVector& OutStart, FVector& OutEnd);
+
+	/**
+	* 트레이스 통계와 액터의 면 가중치를 갱신합니다.
+	**/
+	void RecordHitQuery(int Slot, int Face, bool bHit);
+
+	/**
+	* 소유자를 제외한 연소 액터를 무시하는 충돌 쿼리 파라미터. 트레이스 패스 동안 소유자별로 캐시됩니다.
+	**/
+	const FCollisionQueryParams& GetHitQueryParams(int Slot);
+
+	/**
+	* 트레이스 결과가 셀 소유자의 표면이면 히트 포인트로 기록합니다.
+	**/
+	bool ProcessHitQuery(int Slot, const FHitResult& HitResult);
+
+	/**
+	* 비동기 모드: 남은 히트 수만큼 트레이스를 요청합니다. 결과는 다음 프레임에 OnHitQueryCompleted로 들어옵니다.
+	**/
+	void IssueHitQueries(int Slot, ECollisionChannel BoxType);
+
+	/**
+	**/
+	void OnHitQueryCompleted(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/**
+	* 트레이스 패스를 시작합니다. 무시 목록을 한 번 만들고 트레이스 예산을 정하며, 예산이 있으면 셀을 우선순위(새로 점화된 셀, 플레이어와의 거리) 순으로 정렬합니다.
+	**/
+	void BeginHitQueryPass(TArray<int>& InOutSlots);
+
+	/**
+	* 큐 깊이(히트가 부족해 이월되는 셀 수)와 예산 사용률을 기록하고 패스 캐시를 비웁니다.
+	**/
+	void EndHitQueryPass(const TArray<int>& Slots);
+
+	/**
+	* 표면 샘플링에 실패한 연소 셀을 등록 취소합니다.
+	**/
+	void UnregisterBurningCell(int Slot);
+
+	/**
+	* 히트맵 범위와 겹치는 가연성(ECC_GameTraceChannel1) 액터를 한 번의 겹침 쿼리로 찾습니다.
+	**/
+	void GatherFlammableActors(TArray<AActor*>& OutActors) const;
+
+	/**
+	* 새로 등록된 액터(핸들 FirstOwnerHandle 이후)의 셀에 스태틱 메쉬 표면 샘플을 굽습니다.
+	**/
+	void BakeSurfaceSamples(int FirstOwnerHandle, const TMap<FIntVector, FHeatBox>& InHeatBoxAt, FHeatCellStore& OutCellStore) const;
+
+	/**
+	**/
+	void Diffuse(TArray<float>& Field, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats);
+
+	/**
+	* 현재 속성으로 확산 설정을 만듭니다. 게임 스레드에서만 호출합니다.
+	**/
+	FHeatDiffuseSettings GetDiffuseSettings() const;
+
+	/**
+	* 확산할 것이 없으면 false를 반환합니다.
+	**/
+	bool BeginDiffuse(const TArray<float>& Field, TArray<float>& NewField, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats);
+
+	/**
+	* 스윕(또는 V-cycle) 한 번을 수행하고 수렴했거나 최대 반복에 도달하면 true를 반환합니다.
+	**/
+	bool StepDiffuse(const TArray<float>& Field, TArray<float>& NewField, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats);
+
+	/**
+	**/
+	void EndDiffuse(TArray<float>& Field, TArray<float>& NewField, const FHeatDiffuseSettings& Settings, FHeatDiffuseStats& OutStats);
+
+	/**
+	**/
+	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
+	bool GetMapIndex(const FVector& WorldPos, FIntVector& OutMapIndex) const;
+
+	/**
+	**/
+	UFUNCTION(BlueprintCallable, Category = "RtHeatmap")
+	void GetMapWorldPos(const FIntVector& MapIndex, FVector& WorldPos) const;
+
+	/**
+	**/
+	int CoreIndex(int i, int j, int k) const;
+
+	/**
+	**/
+	int MapToCoreIndex(const FIntVector& MapIndex) const;
 
 	/**
 	**/
@@ -485,6 +1086,11 @@ private:
 	/**
 	**/
 	FVector RandRangeFromBoxSurface(const FVector& Center, const FVector& Spacings);
+
+	/**
+	* 박스 면 위의 점. UV는 [0, 1)^2
+	**/
+	FVector BoxFacePoint(const FVector& Center, const FVector& Spacings, BoxFaces Face, const FVector2D& UV);
 	
 	/**
 	**/
@@ -512,6 +1118,207 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ExposeOnSpawn = "true", AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
 	float UpdateInterval;
 
+	/**
+	* Relaxation: 이완 스윕 반복, Multigrid: V-cycle 반복
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	DiffusionSolver SolverType;
+
+	/**
+	* 히트필드 확산을 Z 슬랩 단위로 나누어 워커 스레드에서 병렬로 수행합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	bool bParallelDiffuse;
+
+	/**
+	* 병렬 확산에 사용할 Z 슬랩 개수 (0 = 코어 수)
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "0", AllowPrivateAccess = "true", EditCondition = "bParallelDiffuse"))
+	int NumDiffuseSlabs;
+
+	/**
+	* 열 누적, 확산, 열 수용을 백그라운드 스레드에서 수행하고 결과는 다음 업데이트에서 반영합니다.
+	* 화염 생성, 태그, 충돌 변경은 계속 게임 스레드에서 처리됩니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	bool bAsyncSimulation;
+
+	/**
+	* 업데이트 파이프라인(트레이스, 화염 집계, 확산 스윕, 데미지 적용)을 여러 프레임에 나누어 수행합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	bool bTimeSlicedSimulation;
+
+	/**
+	* 시간 분할 모드에서 프레임당 사용할 시간 [ms]
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "0.0", AllowPrivateAccess = "true", EditCondition = "bTimeSlicedSimulation"))
+	float TimeSliceBudgetMs;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, Category = "Heat Solver")
+	SimPipelineStage PipelineStage;
+
+	/**
+	* 히트필드를 8x8x8 브릭으로 나누어 열이 있는(또는 열이 입력된) 브릭과 그 주변 한 브릭만 확산합니다.
+	* Relaxation 모드에서만 적용됩니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	bool bSparseDiffusion;
+
+	/**
+	* 브릭 내 최대 열이 이 값 이하이면 브릭을 비우고 비활성화합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "0.0", AllowPrivateAccess = "true", EditCondition = "bSparseDiffusion"))
+	float ActiveBrickThreshold;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int NumActiveBricks;
+
+	/**
+	* 액터 등록 시 스태틱 메쉬 삼각형에서 셀별 표면 샘플을 구워 런타임 트레이스를 대신합니다.
+	* CPU에서 메쉬를 읽을 수 없거나 샘플이 없는 셀은 기존처럼 트레이스합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	bool bBakeSurfaceSamples;
+
+	/**
+	* 등록 시 셀마다 소유자 충돌체가 차지하는 부피 비율을 추정합니다. (셀당 겹침 테스트 64회 추가)
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	bool bComputeCellOccupancy;
+
+	/**
+	* 플레이 중 스폰된 가연성 액터를 자동으로 등록하고, 등록된 액터가 파괴되면 등록을 취소합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	bool bAutoRegisterActors;
+
+	/**
+	* BakeRegistry로 구운 등록 결과. 설정하면 BeginPlay에서 겹침 쿼리 없이 레지스트리를 복원합니다.
+	* 구운 액터가 바뀌었으면 런타임 등록으로 대체합니다. 플레이 중 스폰된 액터는 bAutoRegisterActors로 등록합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	TObjectPtr<UHeatRegistryAsset> BakedRegistry;
+
+	/**
+	* 구운 레지스트리를 복원한 뒤 겹침 쿼리로 구운 액터 목록과 비교하여, 구운 뒤 레벨에 추가된 액터를 런타임에 등록합니다.
+	* 시작 시 겹침 쿼리를 다시 하므로 레벨을 고친 뒤 다시 굽기 전까지만 켭니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "BakedRegistry != nullptr && !bSimHasBegun"))
+	bool bValidateBakedActors;
+
+	/**
+	* Random: 임의의 면과 점 (지터 포함)
+	* Stratified: 셀별 Sobol 수열, 액터에서 히트가 났던 면을 더 자주 고릅니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	HitQuerySamplerType HitQuerySampling;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int NumHitQueryTraces;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int NumHitQueryHits;
+
+	/**
+	* 채택된 히트 하나당 트레이스 수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	float HitQueryAttemptsPerHit;
+
+	/**
+	* 업데이트당 표면 샘플링 트레이스 수 (0 = 제한 없음)
+	* 예산을 넘는 셀은 다음 업데이트로 이월되며, 새로 점화된 셀과 플레이어에 가까운 셀이 먼저 트레이스합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "0", AllowPrivateAccess = "true"))
+	int MaxHitQueriesPerUpdate;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int HitQueriesLastUpdate;
+
+	/**
+	* 직전 업데이트 후 히트가 부족해 대기 중인 셀 수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int HitQueryQueueDepth;
+
+	/**
+	* 직전 업데이트의 예산 사용률 (예산이 없으면 0)
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	float HitQueryBudgetUtilization;
+
+	/**
+	* 연소 셀 표면 샘플링 트레이스를 비동기로 묶어 요청하고 다음 프레임에 결과를 수집합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	bool bAsyncHitQueries;
+
+	/**
+	* 동시에 진행할 수 있는 비동기 트레이스 수
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "1", AllowPrivateAccess = "true", EditCondition = "bAsyncHitQueries"))
+	int MaxInFlightHitQueries;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int NumInFlightHitQueries;
+
+	/**
+	* 스윕당 최대 변화량이 필드 최대 크기의 이 비율 아래로 떨어지면 확산 반복을 멈춥니다.
+	* Multigrid 모드에서는 반복 횟수가 V-cycle 횟수를 의미합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "0.0", AllowPrivateAccess = "true"))
+	float DiffuseTolerance;
+
+	/**
+	* 기본값은 이전의 고정 반복 횟수(20)입니다. 낮추면 수렴한 업데이트를 일찍 끝냅니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "1", AllowPrivateAccess = "true"))
+	int MinDiffuseIterations;
+
+	/**
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "1", AllowPrivateAccess = "true"))
+	int MaxDiffuseIterations;
+
+	/**
+	* 직전 업데이트에서 실제로 수행한 확산 반복 횟수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	int LastDiffuseIterations;
+
+	/**
+	* 직전 업데이트의 마지막 스윕 잔차
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Heat Solver", meta = (AllowPrivateAccess = "true"))
+	float LastDiffuseResidual;
+
+#if WITH_EDITORONLY_DATA
+	/**
+	* 병렬 확산 결과를 직렬 기준 결과와 비교하여 허용 오차를 넘으면 경고합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (AllowPrivateAccess = "true", EditCondition = "bParallelDiffuse"))
+	bool bValidateParallelDiffuse;
+
+	/**
+	* 필드 최댓값 대비 허용되는 상대 오차
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat Solver", meta = (ClampMin = "0.0", AllowPrivateAccess = "true", EditCondition = "bValidateParallelDiffuse"))
+	float DiffuseValidationTolerance;
+#endif
+
 #if WITH_EDITORONLY_DATA	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	bool bShowTemperatureLog; 
@@ -536,6 +1343,20 @@ private:
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ExposeOnSpawn = "true", AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
 	VisualVerbosity ShowHeatMap;
+
+	/**
+	* Visual_HeatColor에서 열을 이 간격으로 양자화하여, 양자화 값이 바뀐 인스턴스만 다시 씁니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", AllowPrivateAccess = "true"))
+	float HeatVizQuantization;
+
+	// 인스턴스별 필드 인덱스와 마지막으로 쓴 양자화 값
+	TArray<int> HeatVizCoreIdx;
+
+	TArray<int> HeatVizLevels;
+
+	// SetCustomData에 넘기는 인스턴스 하나 분량의 재사용 버퍼
+	TArray<float> HeatVizCustomData;
 #endif
 
 	UPROPERTY(VisibleAnywhere)
@@ -546,6 +1367,107 @@ private:
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (ExposeOnSpawn = "true", AllowPrivateAccess = "true"))
 	TSubclassOf<AActor> FireEffectClass;
+
+	/**
+	* 화염 범위가 사라져도 이펙트 액터를 파괴하지 않고 숨겨 두었다가 재사용합니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	bool bPoolFireEffects;
+
+	/**
+	* 시뮬레이션 시작 시 미리 스폰해 둘 이펙트 수
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (ClampMin = "0", AllowPrivateAccess = "true", EditCondition = "bPoolFireEffects"))
+	int FireEffectPoolSize;
+
+	/**
+	* 풀에서 재사용한 횟수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int FireEffectPoolHits;
+
+	/**
+	* 풀이 비어 새로 스폰한 횟수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int FireEffectPoolMisses;
+
+	// 숨겨진 채 재사용을 기다리는 이펙트
+	UPROPERTY(VisibleAnywhere, Category = "Fire Effect")
+	TArray<TObjectPtr<AFireBlob>> PooledFireEffects;
+
+	/**
+	* Actors: 화염 범위마다 FireEffectClass 액터를 배치합니다.
+	* Instanced: 하나의 InstancedFireSystem이 배열 파라미터로 모든 화염 범위를 그립니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (AllowPrivateAccess = "true", EditCondition = "!bSimHasBegun"))
+	FirePresentationMode FirePresentation;
+
+	/**
+	* FirePositions, FireSizes (Vector 배열), FireIntensities (Float 배열) 사용자 파라미터를 읽는 월드 공간 시스템
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (AllowPrivateAccess = "true", EditCondition = "FirePresentation == FirePresentationMode::Instanced"))
+	TObjectPtr<UNiagaraSystem> InstancedFireSystem;
+
+	UPROPERTY(VisibleAnywhere, Category = "Fire Effect")
+	TObjectPtr<UFireInstanceComponent> FireInstances;
+
+	/**
+	* 화염 크기 배율이 이 값보다 적게 바뀌면 이펙트를 갱신하지 않습니다.
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (ClampMin = "0.0", AllowPrivateAccess = "true"))
+	float FireSizeUpdateThreshold;
+
+	/**
+	* 마지막 업데이트에서 반영한 화염 크기 변경 수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int NumFireSizeUpdates;
+
+	/**
+	* 마지막 업데이트에서 임계값 미만이라 건너뛴 화염 크기 변경 수
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int NumFireSizeUpdatesSkipped;
+
+	// 화염 범위 시그니처 -> 반영할 크기 배율
+	TArray<TPair<uint64, float>> PendingFireSizes;
+
+	int PendingFireSizesSkipped = 0;
+
+	/**
+	* 시점과의 거리와 크기로 화염 이펙트의 재생/정지/숨김을 정합니다. (Actors 모드 전용)
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	bool bFireEffectLOD;
+
+	/**
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (ClampMin = "0", AllowPrivateAccess = "true", EditCondition = "bFireEffectLOD"))
+	int MaxFullQualityFires;
+
+	/**
+	**/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fire Effect", meta = (ClampMin = "0.0", AllowPrivateAccess = "true", EditCondition = "bFireEffectLOD"))
+	float FireEffectCullDistance;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int NumFullQualityFires;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int NumPausedFires;
+
+	/**
+	**/
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Fire Effect", meta = (AllowPrivateAccess = "true"))
+	int NumHiddenFires;
+
+	// 화염 범위 시그니처 -> 중요도 (재사용 버퍼)
+	TArray<TPair<uint64, float>> FireSignificance;
 	
 	UPROPERTY()
 	FTimerHandle HeatmapTimer;
@@ -567,13 +1489,63 @@ private:
 
 	UPROPERTY(VisibleAnywhere)
 	TMap<FIntVector, FHeatBox> HeatBoxAt;
-	
-	UPROPERTY(VisibleAnywhere)
-	TArray<AActor*> RegisteredBowOwners;
 
-	TMultiMap<AActor*, TSharedPtr<FFireInBox>> GoingFires;
+	FHeatCellStore CellStore;
+
+	TArray<FHeatCellTransition> PhaseTransitions;
+
+	// 화염 범위 시그니처 -> 진행 중인 화염
+	TMap<uint64, TSharedPtr<FFireInBox>> GoingFires;
+
+	// 화염 집계 세대. 이번 집계에서 다시 찾지 못한 화염은 소멸합니다.
+	uint32 FireGeneration = 0;
+
+	// 화염 범위 히트 포인트 (재사용 버퍼)
+	TArray<FVector> RegionHitPoints;
 
 	TArray<TSharedPtr<FFireInBox>> OrphanedFires;
 
+	FireRegionLabeler RegionLabeler;
+
+	HeatSolver Solver;
+
+	HeatMultigrid Multigrid;
+
+	// 다음 확산 전에 활성화할 셀 (게임 스레드 전용)
+	TArray<FIntVector> PendingHeatInputs;
+
+	FHeatSimBuffer SimBuffer;
+
+	TFuture<void> HeatSimTask;
+
+	// 시간 분할 파이프라인 작업 목록과 진행 위치
+	TArray<int> SliceSlots;
+
+	TArray<uint8> SliceSlotGenerations;
+
+	TArray<AActor*> SliceOwners;
+
+	int SliceCursor;
+
+	FTraceDelegate HitQueryDelegate;
+
+	// 이번 업데이트에 남은 트레이스 예산
+	int HitQueryBudgetRemaining;
+
+	// 트레이스 패스 동안 재사용하는 연소 액터 목록과 소유자별 쿼리 파라미터
+	TArray<AActor*> HitQueryIgnoredActors;
+
+	TMap<const AActor*, FCollisionQueryParams> HitQueryParamsOf;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	TArray<TWeakObjectPtr<AActor>> PendingSpawnedActors;
+
+	TArray<float> SliceField;
+
+	FHeatDiffuseSettings SliceDiffuseSettings;
+
+	FHeatDiffuseStats SliceDiffuseStats;
+
 };
 
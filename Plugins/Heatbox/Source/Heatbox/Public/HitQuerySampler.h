@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* 셀 표면 트레이스 시작점을 위한 저불일치(low-discrepancy) 수열
+* 면은 가중치(이전에 히트가 난 면일수록 큼)에 따라 층화하여 고르고, 면 위의 점은 2D Sobol 수열로 고릅니다.
+**/
+class HEATBOX_API HitQuerySampler
+{
+public:
+	static constexpr int NumFaces = 6;
+
+	/**
+	* Index번째 2D Sobol 점. 셀마다 다른 Scramble 값으로 XOR 스크램블합니다.
+	**/
+	static FVector2D Sobol2D(uint32 Index, uint32 Scramble);
+
+	/**
+	* [0, 1) 구간의 3진 역순 수(Radical inverse)에 Shift만큼 회전을 더합니다.
+	**/
+	static float RadicalInverse3(uint32 Index, float Shift);
+
+	/**
+	* 면 가중치의 누적 분포에서 U에 해당하는 면
+	**/
+	static int PickFace(const float* FaceWeights, float U);
+
+	/**
+	**/
+	static uint32 CellScramble(const FIntVector& MapIndex);
+};